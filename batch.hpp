@@ -0,0 +1,502 @@
+/*
+    Batch mode
+    Description:
+    Runs many small MST / TSP / max-flow / Voronoi instances listed in a
+    JSONL manifest, one job object per line:
+
+      {"id": "a", "type": "mst", "input": "graph.txt"}
+      {"id": "e", "type": "mst", "input": "roads.edges", "format": "edges"}
+      {"id": "b", "type": "tsp", "input": "input.txt", "seconds": 0.2}
+      {"id": "c", "type": "maxflow", "input": "small_instance.dimacs"}
+      {"id": "d", "type": "voronoi", "input": "sites.txt"}
+
+    Jobs are claimed one at a time by the workers of a bounded
+    ThreadPool. Each worker owns a BatchArena with the input buffers of
+    every job type. The buffers are cleared but not freed between jobs,
+    so after the first few jobs loading allocates nothing. Every solver
+    runs single-threaded, so the pool is the only source of parallelism.
+    MST inputs are adjacency matrices unless "format" is "edges", which
+    reads a text or binary edge list (external_mst.hpp) instead.
+    Results are written as one JSON line per job in completion order,
+    tagged with the manifest line number and the job id:
+
+      {"line":1,"id":"a","type":"mst","status":"ok","seconds":0.0001,
+       "result":{"cost":4,"edges":[[2,3,1],...]}}
+*/
+
+#ifndef BATCH_HPP
+#define BATCH_HPP
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <charconv>
+#include <filesystem>
+#include <system_error>
+#include "thread_pool.hpp"
+#include "instrumentation.hpp"
+#include "prim.hpp"
+#include "external_mst.hpp"
+#include "distance_matrix.hpp"
+#include "tsp_held_karp.hpp"
+#include "ford_fulkerson.hpp"
+#include "voronoi_sites.hpp"
+#ifdef HAVE_VORONOI
+#include "voronoi.hpp"
+#endif
+using namespace std;
+
+/*
+    Structure: BatchJob
+    Description:
+    One manifest line. A line that does not parse keeps its error here
+    and is reported in the results like a failed job.
+*/
+struct BatchJob {
+    size_t line = 0;
+    string id;
+    string type;            // mst, tsp, maxflow or voronoi
+    string input;           // instance file
+    string format;          // MST input: matrix (default) or edges
+    double seconds = 1.0;   // TSP local search budget
+    string error;
+};
+
+/*
+    Structure: BatchArena
+    Description:
+    Per-worker buffers reused by every job the worker runs.
+*/
+struct BatchArena {
+    vector<int> matrix;                 // MST adjacency matrix
+    vector<FlatEdge> edges;             // MST edge list
+    DistanceMatrix<int32_t> distances;  // TSP distances
+    FlowNetwork network;                // max-flow arcs
+    vector<SitePoint> sites;            // Voronoi sites
+    string body;                        // "result" object of the current job
+    string result;                      // full result line of the current job
+};
+
+// Appends value as a JSON string literal
+inline void appendJsonString(string &out, const string &value) {
+    out += '"';
+    for (char c : value) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (c == '\n') {
+            out += "\\n";
+        } else if (c == '\t') {
+            out += "\\t";
+        } else if ((unsigned char)c < 0x20) {
+            char code[8];
+            snprintf(code, sizeof code, "\\u%04x", c);
+            out += code;
+        } else {
+            out += c;
+        }
+    }
+    out += '"';
+}
+
+// Appends a number in its shortest round-trip form
+template <class Number>
+void appendNumber(string &out, Number value) {
+    char digits[32];
+    auto result = to_chars(digits, digits + sizeof digits, value);
+    out.append(digits, result.ptr);
+}
+
+/*
+    Function: parseBatchJob
+    Description:
+    Parses one flat JSON object with string and number members. Members
+    other than id, type, input, format and seconds are ignored.
+
+    Parameters:
+    text: the manifest line
+    job: output job (its line number is left untouched)
+
+    Return value:
+    true on success; false with job.error set otherwise
+*/
+inline bool parseBatchJob(const string &text, BatchJob &job) {
+    const char *p = text.data();
+    const char *end = p + text.size();
+    auto skip = [&] {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')) p++;
+    };
+    auto fail = [&](const char *message) {
+        job.error = message;
+        return false;
+    };
+    auto readString = [&](string &value) {
+        value.clear();
+        if (p == end || *p != '"') return false;
+        for (p++; p < end && *p != '"'; p++) {
+            if (*p == '\\') {
+                if (++p == end) return false;
+                switch (*p) {
+                    case 'n': value += '\n'; break;
+                    case 't': value += '\t'; break;
+                    case 'r': value += '\r'; break;
+                    case 'b': value += '\b'; break;
+                    case 'f': value += '\f'; break;
+                    case '"':
+                    case '\\':
+                    case '/': value += *p; break;
+                    default: return false;
+                }
+            } else {
+                value += *p;
+            }
+        }
+        if (p == end) return false;
+        p++;
+        return true;
+    };
+
+    skip();
+    if (p == end || *p != '{') {
+        return fail("expected a JSON object");
+    }
+    p++;
+    skip();
+    if (p < end && *p == '}') {
+        p++;
+    } else {
+        string key, value;
+        while (true) {
+            skip();
+            if (!readString(key)) {
+                return fail("expected a member name");
+            }
+            skip();
+            if (p == end || *p != ':') {
+                return fail("expected ':'");
+            }
+            p++;
+            skip();
+            if (p < end && *p == '"') {
+                if (!readString(value)) {
+                    return fail("unterminated or unsupported string");
+                }
+                if (key == "id") job.id = value;
+                else if (key == "type") job.type = value;
+                else if (key == "input") job.input = value;
+                else if (key == "format") job.format = value;
+            } else {
+                const char *start = p;
+                while (p < end && *p != ',' && *p != '}' && *p != ' ' && *p != '\t') p++;
+                if (key == "seconds") {
+                    auto result = from_chars(start, p, job.seconds);
+                    if (result.ec != errc() || result.ptr != p || job.seconds < 0) {
+                        return fail("seconds must be a non-negative number");
+                    }
+                } else if (key == "id") {
+                    job.id.assign(start, p);   // numeric ids are kept as written
+                } else if (start == p) {
+                    return fail("expected a value");
+                }
+            }
+            skip();
+            if (p < end && *p == ',') {
+                p++;
+                continue;
+            }
+            if (p < end && *p == '}') {
+                p++;
+                break;
+            }
+            return fail("expected ',' or '}'");
+        }
+    }
+    skip();
+    if (p != end) {
+        return fail("trailing characters after the object");
+    }
+    if (job.type.empty() || job.input.empty()) {
+        return fail("type and input are required");
+    }
+    return true;
+}
+
+/*
+    Function: readBatchManifest
+    Description:
+    Reads every non-blank line of a JSONL manifest. Malformed lines are
+    kept as jobs carrying an error.
+
+    Return value:
+    true if the manifest could be opened
+*/
+inline bool readBatchManifest(const string &filename, vector<BatchJob> &jobs) {
+    ifstream in(filename);
+    if (!in.is_open()) {
+        cerr << "Error: could not open manifest " << filename << "\n";
+        return false;
+    }
+    string text;
+    for (size_t line = 1; getline(in, text); line++) {
+        if (text.find_first_not_of(" \t\r") == string::npos) {
+            continue;
+        }
+        BatchJob job;
+        job.line = line;
+        parseBatchJob(text, job);
+        jobs.push_back(move(job));
+    }
+    return true;
+}
+
+// Job bodies: each appends the "result" object to out and returns an
+// empty string, or returns an error message
+
+inline string runMSTJob(const BatchJob &job, BatchArena &arena, string &out) {
+    INSTRUMENT_CLOCK(phases);
+    pair<long long, vector<FlatEdge>> mst;
+    if (job.format == "edges") {
+        int V = 0;
+        if (!readEdgeList(job.input, V, arena.edges)) {
+            return "could not read the edge list";
+        }
+        INSTRUMENT_LAP(phases, Parse);
+        mst = kruskalsMSTFlat(V, arena.edges, 1);
+    } else if (job.format.empty() || job.format == "matrix") {
+        ifstream file(job.input);
+        int V;
+        if (!file.is_open() || !(file >> V) || V < 0) {
+            return "could not read the matrix size";
+        }
+        // Every entry takes at least a digit and a separator, so a size
+        // the file cannot hold is rejected before allocating the matrix
+        error_code sizeError;
+        uint64_t bytes = filesystem::file_size(job.input, sizeError);
+        if (sizeError || (uint64_t)V * V > bytes / 2 + 1) {
+            return "matrix size exceeds the file";
+        }
+        arena.matrix.resize((size_t)V * V);
+        for (auto &w : arena.matrix) {
+            if (!(file >> w)) {
+                return "matrix is truncated";
+            }
+        }
+        INSTRUMENT_LAP(phases, Parse);
+        mst = mstFromMatrix(V, arena.matrix, MSTAlgorithm::Auto, 1);
+    } else {
+        return "format must be matrix or edges";
+    }
+    INSTRUMENT_LAP(phases, Solve);
+    const auto &[cost, edges] = mst;
+    out += "{\"cost\":";
+    appendNumber(out, cost);
+    out += ",\"edges\":[";
+    for (size_t i = 0; i < edges.size(); i++) {
+        if (i > 0) out += ',';
+        out += '[';
+        appendNumber(out, edges[i].u);
+        out += ',';
+        appendNumber(out, edges[i].v);
+        out += ',';
+        appendNumber(out, edges[i].w);
+        out += ']';
+    }
+    out += "]}";
+    INSTRUMENT_LAP(phases, Output);
+    return "";
+}
+
+inline string runTSPJob(const BatchJob &job, BatchArena &arena, string &out) {
+    INSTRUMENT_CLOCK(phases);
+    ifstream file(job.input);
+    if (!file.is_open() || !readDistanceMatrix(file, arena.distances)) {
+        return "could not read the distance matrix";
+    }
+    INSTRUMENT_LAP(phases, Parse);
+    auto [distance, route] = tspSolve(arena.distances, job.seconds, 1);
+    INSTRUMENT_LAP(phases, Solve);
+    out += "{\"distance\":";
+    appendNumber(out, distance);
+    out += ",\"route\":[";
+    for (size_t i = 0; i < route.size(); i++) {
+        if (i > 0) out += ',';
+        appendNumber(out, route[i]);
+    }
+    out += "]}";
+    INSTRUMENT_LAP(phases, Output);
+    return "";
+}
+
+inline string runMaxFlowJob(const BatchJob &job, BatchArena &arena, string &out) {
+    INSTRUMENT_CLOCK(phases);
+    FlowNetwork &network = arena.network;
+    if (!readFlowNetwork(job.input, network)) {
+        return "could not read the DIMACS instance";
+    }
+    if (network.source == -1 || network.sink == -1) {
+        return "instance has no source or sink";
+    }
+    INSTRUMENT_LAP(phases, Parse);
+    MaxFlowSolver solver(network.nodes, network.arcs);
+    INSTRUMENT_LAP(phases, Build);
+    long long flow = solver.solve(network.source, network.sink);
+    INSTRUMENT_LAP(phases, Solve);
+    out += "{\"flow\":";
+    appendNumber(out, flow);
+    out += '}';
+    INSTRUMENT_LAP(phases, Output);
+    return "";
+}
+
+inline string runVoronoiJob(const BatchJob &job, BatchArena &arena, string &out) {
+#ifdef HAVE_VORONOI
+    INSTRUMENT_CLOCK(phases);
+    vector<SitePoint> &sites = arena.sites;
+    if (!readSites(job.input, sites)) {
+        return "could not read the sites";
+    }
+    size_t count = sites.size();
+    for (const auto &corner : boundingSites(siteBounds(sites))) {
+        sites.push_back(corner);
+    }
+    INSTRUMENT_LAP(phases, Parse);
+    CellList cells = tiledVoronoiCells(toPoints(sites), 1, 1);
+    INSTRUMENT_LAP(phases, Build);
+    out += "{\"sites\":";
+    appendNumber(out, count);
+    out += ",\"cells\":[";
+    const double *xy = cells.xy.data();
+    for (size_t c = 0; c < cells.sites.size(); c++) {
+        if (c > 0) out += ',';
+        out += '[';
+        appendNumber(out, cells.sites[c]);
+        out += ",[";
+        for (uint32_t v = 0; v < cells.sizes[c]; v++, xy += 2) {
+            if (v > 0) out += ',';
+            out += '[';
+            appendNumber(out, xy[0]);
+            out += ',';
+            appendNumber(out, xy[1]);
+            out += ']';
+        }
+        out += "]]";
+    }
+    out += "]}";
+    INSTRUMENT_LAP(phases, Output);
+    return "";
+#else
+    (void)job;
+    (void)arena;
+    (void)out;
+    return "built without CGAL";
+#endif
+}
+
+/*
+    Function: runBatchJob
+    Description:
+    Runs one job with the worker's arena and formats its result line
+    into arena.result (without the trailing newline). An exception from
+    a job (bad_alloc on a huge input, for instance) becomes that job's
+    error line instead of ending the batch.
+
+    Return value:
+    true if the job succeeded
+*/
+inline bool runBatchJob(const BatchJob &job, BatchArena &arena) {
+    auto started = chrono::steady_clock::now();
+    string &body = arena.body;
+    body.clear();
+    string error = job.error;
+    if (error.empty()) {
+        try {
+            if (job.type == "mst") error = runMSTJob(job, arena, body);
+            else if (job.type == "tsp") error = runTSPJob(job, arena, body);
+            else if (job.type == "maxflow") error = runMaxFlowJob(job, arena, body);
+            else if (job.type == "voronoi") error = runVoronoiJob(job, arena, body);
+            else error = "unknown job type (mst, tsp, maxflow or voronoi)";
+        } catch (const exception &e) {
+            error = string("exception: ") + e.what();
+        } catch (...) {
+            error = "unknown exception";
+        }
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+
+    string &out = arena.result;
+    out.clear();
+    out += "{\"line\":";
+    appendNumber(out, job.line);
+    out += ",\"id\":";
+    appendJsonString(out, job.id);
+    out += ",\"type\":";
+    appendJsonString(out, job.type);
+    if (!error.empty()) {
+        out += ",\"status\":\"error\",\"error\":";
+        appendJsonString(out, error);
+        out += '}';
+        return false;
+    }
+    out += ",\"status\":\"ok\",\"seconds\":";
+    appendNumber(out, seconds);
+    out += ",\"result\":";
+    out += body;
+    out += '}';
+    return true;
+}
+
+/*
+    Function: runBatch
+    Description:
+    Runs every job of the manifest and writes the result lines to out as
+    the jobs finish, flushing after each line.
+
+    Parameters:
+    manifest: JSONL job file
+    out: open result stream
+    workers: jobs run at the same time (0 = hardware threads)
+
+    Return value:
+    true if the manifest was read and every job succeeded
+*/
+inline bool runBatch(const string &manifest, FILE *out, unsigned workers = 0) {
+    vector<BatchJob> jobs;
+    if (!readBatchManifest(manifest, jobs)) {
+        return false;
+    }
+    auto started = chrono::steady_clock::now();
+    ThreadPool pool(workers);
+    vector<BatchArena> arenas(pool.size());
+    mutex outputLock;
+    atomic<size_t> failed(0);
+    bool written = true;
+
+    pool.parallelFor(jobs.size(), 1, [&](unsigned worker, size_t begin, size_t end) {
+        BatchArena &arena = arenas[worker];
+        for (size_t i = begin; i < end; i++) {
+            if (!runBatchJob(jobs[i], arena)) {
+                failed.fetch_add(1, memory_order_relaxed);
+            }
+            arena.result += '\n';
+            lock_guard<mutex> lock(outputLock);
+            written = fwrite(arena.result.data(), 1, arena.result.size(), out) == arena.result.size() &&
+                      fflush(out) == 0 && written;
+        }
+    });
+
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+    cerr << "Batch: " << jobs.size() << " jobs, " << failed.load() << " failed, " << pool.size()
+         << " workers, " << seconds << " s\n";
+    if (!written) {
+        cerr << "Error: could not write the batch results\n";
+    }
+    return written && failed.load() == 0;
+}
+
+#endif
@@ -0,0 +1,318 @@
+/*
+    Benchmarks
+    Description:
+    Times the MST, TSP, max-flow and Voronoi engines on seeded synthetic
+    instances (see instance_generators.hpp). Every benchmark runs its
+    warmup rounds, then the timed repetitions. Setup work, such as
+    copying an input that the solver consumes, runs before each round
+    and is not timed. One JSON line per benchmark goes to standard
+    output:
+
+      {"benchmark":"mst.kruskalsMST","instance":"geometric","n":20000,
+       "m":160012,"reps":5,"median_s":0.021,"min_s":0.020,"max_s":0.023,
+       "throughput":7.6e+06,"unit":"edges/s","check":1234567}
+
+    check is the solver's answer (tree cost, tour length, flow value,
+    cell count). It must not change between runs with the same seed,
+    and engines solving the same instance must agree on it.
+*/
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+#include <memory>
+#include <iomanip>
+#include "instance_generators.hpp"
+#include "kruskal.hpp"
+#include "prim.hpp"
+#include "tspNearestNeighbor.hpp"
+#include "tsp_local_search.hpp"
+#include "tsp_held_karp.hpp"
+#include "ford_fulkerson.hpp"
+#include "instrumentation.hpp"
+#ifdef HAVE_VORONOI
+#include "voronoi.hpp"
+#endif
+using namespace std;
+
+/*
+    Structure: BenchmarkOptions
+    Description:
+    Instance sizes and run settings, all settable from the command line.
+*/
+struct BenchmarkOptions {
+    uint64_t seed = 1;
+    int warmup = 1;
+    int reps = 5;
+    unsigned threads = 0;       // parallel engines (0 = hardware threads)
+    string only;                // comma-separated groups, empty = all
+    string metrics;             // instrumentation report file, empty = none
+    int mstVertices = 20000;    // geometric graph for Kruskal
+    double mstDegree = 16;      // its average degree
+    int denseVertices = 2000;   // dense matrix for Prim
+    int cities = 500;           // Euclidean TSP
+    int exactCities = 16;       // Held-Karp
+    int gridSide = 40;          // grid flow network is gridSide x gridSide
+    int layers = 20;            // layered flow network
+    int layerWidth = 80;
+    int sites = 100000;         // Voronoi
+    int clusters = 20;
+};
+
+static bool wanted(const BenchmarkOptions &options, const string &group) {
+    if (options.only.empty()) {
+        return true;
+    }
+    string list = "," + options.only + ",";
+    return list.find("," + group + ",") != string::npos;
+}
+
+/*
+    Function: measure
+    Description:
+    Runs setup() then body() warmup + reps times, timing body() only,
+    and prints the result line.
+
+    Parameters:
+    name: benchmark name, "group.engine"
+    instance: generator name
+    n, m: instance size (vertices / cities / sites, and edges or arcs)
+    items: work units per run for the throughput figure
+    unit: throughput unit
+    setup: untimed preparation before every run
+    body: timed run; returns the check value
+*/
+template <class Setup, class Body>
+void measure(const BenchmarkOptions &options, const char *name, const char *instance, size_t n, size_t m,
+             double items, const char *unit, Setup setup, Body body) {
+    vector<double> times;
+    double check = 0;
+    for (int round = 0; round < options.warmup + options.reps; round++) {
+        setup();
+        auto started = chrono::steady_clock::now();
+        check = (double)body();
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+        if (round >= options.warmup) {
+            times.push_back(seconds);
+        }
+    }
+    sort(times.begin(), times.end());
+    size_t count = times.size();
+    double median = count % 2 ? times[count / 2] : (times[count / 2 - 1] + times[count / 2]) / 2;
+    cout << "{\"benchmark\":\"" << name << "\",\"instance\":\"" << instance << "\",\"n\":" << n
+         << ",\"m\":" << m << ",\"reps\":" << count << ",\"median_s\":" << median
+         << ",\"min_s\":" << times.front() << ",\"max_s\":" << times.back()
+         << ",\"throughput\":" << (median > 0 ? items / median : 0) << ",\"unit\":\"" << unit
+         << "\",\"check\":" << setprecision(17) << check << setprecision(6) << "}" << endl;
+}
+
+static void noSetup() {}
+
+static void benchmarkMST(const BenchmarkOptions &options) {
+    int V = options.mstVertices;
+    vector<FlatEdge> edges = geometricGraph(V, options.mstDegree, options.seed);
+    size_t E = edges.size();
+    vector<FlatEdge> work;
+    auto copyEdges = [&] { work = edges; };
+
+    vector<vector<int>> nested;
+    auto copyNested = [&] {
+        nested.clear();
+        nested.reserve(E);
+        for (const auto &e : edges) nested.push_back({(int)e.u, (int)e.v, e.w});
+    };
+    measure(options, "mst.kruskalsMST", "geometric", V, E, E, "edges/s", copyNested,
+            [&] { return kruskalsMST(V, nested).first; });
+    measure(options, "mst.kruskalsMSTFlat", "geometric", V, E, E, "edges/s", copyEdges,
+            [&] { return kruskalsMSTFlat(V, work, options.threads).first; });
+    measure(options, "mst.filterKruskalMST", "geometric", V, E, E, "edges/s", copyEdges,
+            [&] { return filterKruskalMST(V, work, options.threads).first; });
+
+    int D = options.denseVertices;
+    vector<int> matrix = denseMatrix(D, options.seed);
+    size_t pairs = (size_t)D * (D - 1) / 2;
+    measure(options, "mst.primDenseMST", "dense", D, pairs, pairs, "edges/s", noSetup,
+            [&] { return primDenseMST(D, matrix).first; });
+    measure(options, "mst.mstFromMatrix.kruskal", "dense", D, pairs, pairs, "edges/s", noSetup,
+            [&] { return mstFromMatrix(D, matrix, MSTAlgorithm::Kruskal, options.threads).first; });
+}
+
+static void benchmarkTSP(const BenchmarkOptions &options) {
+    int n = options.cities;
+    size_t pairs = (size_t)n * (n - 1);
+    DistanceMatrix<int32_t> graph = euclideanMatrix<int32_t>(n, options.seed);
+    DistanceMatrix<int16_t> narrow = euclideanMatrix<int16_t>(n, options.seed);
+    DistanceMatrix<float> real = euclideanMatrix<float>(n, options.seed);
+    vector<vector<int>> nested(n, vector<int>(n, 0));
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            if (i != j) nested[i][j] = graph.at(i, j);
+        }
+    }
+
+    // One full nearest-neighbor tour per start city
+    measure(options, "tsp.tspRepetitiveNearestNeighbor.nested", "euclidean", n, pairs, n, "tours/s", noSetup,
+            [&] { return tspRepetitiveNearestNeighbor(n, nested, options.threads).first; });
+    measure(options, "tsp.tspRepetitiveNearestNeighbor.int32", "euclidean", n, pairs, n, "tours/s", noSetup,
+            [&] { return tspRepetitiveNearestNeighbor(graph, options.threads).first; });
+    measure(options, "tsp.tspRepetitiveNearestNeighbor.int16", "euclidean", n, pairs, n, "tours/s", noSetup,
+            [&] { return tspRepetitiveNearestNeighbor(narrow, options.threads).first; });
+    measure(options, "tsp.tspRepetitiveNearestNeighbor.float", "euclidean", n, pairs, n, "tours/s", noSetup,
+            [&] { return tspRepetitiveNearestNeighbor(real, options.threads).first; });
+
+    auto start = tspNearestNeighbor(graph, 0);
+    measure(options, "tsp.tspLocalSearch", "euclidean", n, pairs, n, "cities/s", noSetup,
+            [&] { return tspLocalSearch(graph, start, 60.0, 8, options.threads).first; });
+
+    int k = options.exactCities;
+    if (k >= 2 && k <= heldKarpMaxCities) {
+        DistanceMatrix<int32_t> small = euclideanMatrix<int32_t>(k, options.seed);
+        double states = (double)(1u << (k - 1)) * (k - 1);
+        measure(options, "tsp.tspHeldKarp", "euclidean", k, (size_t)k * (k - 1), states, "states/s", noSetup,
+                [&] { return tspHeldKarp(small, options.threads).first; });
+    }
+}
+
+static void benchmarkFlowInstance(const BenchmarkOptions &options, const char *instance,
+                                  const FlowNetwork &network) {
+    size_t V = network.nodes, E = network.arcs.size();
+    int s = network.source, t = network.sink;
+
+    // The matrix engine holds V^2 64-bit capacities; skip it where that
+    // is too big (256 MB)
+    if (V <= 5792) {
+        ResidualMatrix prototype, graph;
+        buildResidualMatrix(network, prototype);
+        measure(options, "flow.edmondsKarp", instance, V, E, E, "arcs/s", [&] { graph = prototype; },
+                [&] { return edmondsKarp(graph, s, t); });
+    }
+
+    const pair<const char *, MaxFlowSolver::Algorithm> engines[] = {
+        {"flow.MaxFlowSolver.dinic", MaxFlowSolver::Algorithm::Dinic},
+        {"flow.MaxFlowSolver.edmondsKarp", MaxFlowSolver::Algorithm::EdmondsKarp},
+        {"flow.MaxFlowSolver.pushRelabel", MaxFlowSolver::Algorithm::PushRelabel},
+    };
+    unique_ptr<MaxFlowSolver> solver;
+    for (const auto &engine : engines) {
+        measure(options, engine.first, instance, V, E, E, "arcs/s",
+                [&] {
+                    solver.reset(new MaxFlowSolver(network.nodes, network.arcs));
+                    solver->setThreads(options.threads);
+                },
+                [&] { return solver->solve(s, t, engine.second); });
+    }
+}
+
+static void benchmarkFlow(const BenchmarkOptions &options) {
+    benchmarkFlowInstance(options, "grid", gridFlowNetwork(options.gridSide, options.gridSide, options.seed));
+    benchmarkFlowInstance(options, "layered", layeredFlowNetwork(options.layers, options.layerWidth, 4, options.seed));
+}
+
+#ifdef HAVE_VORONOI
+static void benchmarkVoronoiInstance(const BenchmarkOptions &options, const char *instance,
+                                     vector<SitePoint> sites) {
+    size_t n = sites.size();
+    for (const auto &corner : boundingSites(siteBounds(sites))) {
+        sites.push_back(corner);
+    }
+    vector<Point2> points = toPoints(sites);
+
+    measure(options, "voronoi.buildVoronoiDiagram", instance, n, 0, n, "sites/s", noSetup,
+            [&] { return buildVoronoiDiagram(points).number_of_faces(); });
+    measure(options, "voronoi.tiledVoronoiCells", instance, n, 0, n, "sites/s", noSetup,
+            [&] { return tiledVoronoiCells(points, 4, options.threads).sites.size(); });
+
+    DelaunayTriangulation triangulation;
+    buildTriangulation(points, triangulation);
+    NearestSiteLocator locator(triangulation);
+    vector<SitePoint> queries = randomPoints(n, options.seed + 1);
+    SiteBounds box = siteBounds(vector<SitePoint>(sites.begin(), sites.begin() + n));
+    for (auto &q : queries) {
+        q.x = box.minX + q.x * (box.maxX - box.minX);
+        q.y = box.minY + q.y * (box.maxY - box.minY);
+    }
+    vector<Point2> queryPoints = toPoints(queries);
+    vector<unsigned> nearest;
+    measure(options, "voronoi.NearestSiteLocator", instance, n, 0, n, "queries/s", noSetup, [&] {
+        locator.locate(queryPoints, nearest, options.threads);
+        return nearest.empty() ? 0 : nearest[0];
+    });
+}
+#endif
+
+static void benchmarkVoronoi(const BenchmarkOptions &options) {
+#ifdef HAVE_VORONOI
+    benchmarkVoronoiInstance(options, "random", randomPoints(options.sites, options.seed));
+    benchmarkVoronoiInstance(options, "clustered", clusteredPoints(options.sites, options.clusters, options.seed));
+#else
+    (void)options;
+    cerr << "Voronoi benchmarks skipped: built without CGAL\n";
+#endif
+}
+
+/*
+    Function: main
+    Description:
+    Parses the options and runs the selected benchmark groups.
+
+    Parameters:
+    --only mst,tsp,flow,voronoi: groups to run (default: all)
+    --seed, --warmup, --reps, --threads: run settings
+    --metrics: instrumentation report for the whole run (see main.cpp)
+    --mst-vertices, --mst-degree, --dense-vertices, --cities,
+    --exact-cities, --grid-side, --layers, --layer-width, --sites,
+    --clusters: instance sizes
+
+    Return value:
+    0 on success, 1 on an unknown option
+*/
+int main(int argc, char *argv[]) {
+    BenchmarkOptions options;
+    for (int i = 1; i < argc; i++) {
+        const char *value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (value == nullptr) {
+            cerr << "Error: missing value for " << argv[i] << "\n";
+            return 1;
+        }
+        if (strcmp(argv[i], "--only") == 0) options.only = value;
+        else if (strcmp(argv[i], "--metrics") == 0) options.metrics = value;
+        else if (strcmp(argv[i], "--seed") == 0) options.seed = strtoull(value, nullptr, 10);
+        else if (strcmp(argv[i], "--warmup") == 0) options.warmup = max(0, atoi(value));
+        else if (strcmp(argv[i], "--reps") == 0) options.reps = max(1, atoi(value));
+        else if (strcmp(argv[i], "--threads") == 0) options.threads = (unsigned)atoi(value);
+        else if (strcmp(argv[i], "--mst-vertices") == 0) options.mstVertices = atoi(value);
+        else if (strcmp(argv[i], "--mst-degree") == 0) options.mstDegree = atof(value);
+        else if (strcmp(argv[i], "--dense-vertices") == 0) options.denseVertices = atoi(value);
+        else if (strcmp(argv[i], "--cities") == 0) options.cities = atoi(value);
+        else if (strcmp(argv[i], "--exact-cities") == 0) options.exactCities = atoi(value);
+        else if (strcmp(argv[i], "--grid-side") == 0) options.gridSide = atoi(value);
+        else if (strcmp(argv[i], "--layers") == 0) options.layers = atoi(value);
+        else if (strcmp(argv[i], "--layer-width") == 0) options.layerWidth = atoi(value);
+        else if (strcmp(argv[i], "--sites") == 0) options.sites = atoi(value);
+        else if (strcmp(argv[i], "--clusters") == 0) options.clusters = atoi(value);
+        else {
+            cerr << "Error: unknown option " << argv[i] << "\n";
+            return 1;
+        }
+        i++;
+    }
+    if (options.mstVertices < 1 || options.denseVertices < 1 || options.cities < 1 || options.gridSide < 1 ||
+        options.layers < 2 || options.layerWidth < 1 || options.sites < 1) {
+        cerr << "Error: instance sizes must be positive (at least 2 layers)\n";
+        return 1;
+    }
+
+    if (wanted(options, "mst")) benchmarkMST(options);
+    if (wanted(options, "tsp")) benchmarkTSP(options);
+    if (wanted(options, "flow")) benchmarkFlow(options);
+    if (wanted(options, "voronoi")) benchmarkVoronoi(options);
+    if (!options.metrics.empty() && !instrumentation::writeMetricsReport(options.metrics)) {
+        cerr << "Error: could not write metrics to " << options.metrics << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,403 @@
+/*
+    DIMACS max flow loader
+    Description:
+    Parses DIMACS max flow instances (c / p / n / a lines) straight from
+    a memory-mapped file with a hand-written integer scanner. A first pass
+    counts the arc lines, a second pass fills an exactly-sized arc array,
+    so no memory is allocated per line. Standard input ("-") and pipes
+    cannot be mapped, so they are parsed in a single pass over a large
+    reusable read buffer instead.
+*/
+
+#ifndef DIMACS_LOADER_HPP
+#define DIMACS_LOADER_HPP
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <climits>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Structure: FlowArc
+// Represents an input arc for MaxFlowSolver with 0-based endpoints
+// and a 64-bit capacity
+struct FlowArc {
+    int from;
+    int to;
+    long long capacity;
+};
+
+// Structure: FlowNetwork
+// Holds a parsed flow instance without any dense V x V storage
+struct FlowNetwork {
+    int nodes = 0;
+    int source = -1;
+    int sink = -1;
+    std::vector<FlowArc> arcs;
+};
+
+// Structure: DimacsLoadStats
+// Size and timing of one load, used to report parse throughput
+struct DimacsLoadStats {
+    size_t bytes = 0;
+    double seconds = 0.0;
+    bool mapped = false;
+
+    double megabytesPerSecond() const {
+        return seconds > 0.0 ? (bytes / (1024.0 * 1024.0)) / seconds : 0.0;
+    }
+};
+
+// Class: MappedFile
+// Read-only memory mapping of a whole regular file. Leaves data()
+// null when the path cannot be mapped (missing file, pipe, device).
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& filename) {
+#ifdef _WIN32
+        file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                           OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE || GetFileType(file) != FILE_TYPE_DISK) {
+            return;
+        }
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+            return;
+        }
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping == nullptr) {
+            return;
+        }
+        void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (view != nullptr) {
+            bytes = static_cast<const char*>(view);
+            length = static_cast<size_t>(fileSize.QuadPart);
+        }
+#else
+        int fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return;
+        }
+        struct stat info;
+        if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+            void* view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (view != MAP_FAILED) {
+                madvise(view, static_cast<size_t>(info.st_size), MADV_SEQUENTIAL);
+                bytes = static_cast<const char*>(view);
+                length = static_cast<size_t>(info.st_size);
+            }
+        }
+        close(fd);
+#endif
+    }
+
+    ~MappedFile() {
+#ifdef _WIN32
+        if (bytes != nullptr) UnmapViewOfFile(bytes);
+        if (mapping != nullptr) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+#else
+        if (bytes != nullptr) munmap(const_cast<char*>(bytes), length);
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const { return bytes; }
+    size_t size() const { return length; }
+
+private:
+    const char* bytes = nullptr;
+    size_t length = 0;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#endif
+};
+
+// Class: DimacsParser
+// Line parser shared by the mapped and the streaming loaders.
+// Lines are given as [p, end) ranges; the last line may lack a newline.
+class DimacsParser {
+public:
+    explicit DimacsParser(FlowNetwork& network) : network(network) {}
+
+    // Function: countArcs
+    // First pass over a mapped file: number of lines starting with 'a'
+    // Time Complexity: O(bytes)
+    static size_t countArcs(const char* p, const char* end) {
+        size_t count = 0;
+        while (p < end) {
+            if (*p == 'a') {
+                ++count;
+            }
+            const void* newline = std::memchr(p, '\n', static_cast<size_t>(end - p));
+            if (newline == nullptr) {
+                break;
+            }
+            p = static_cast<const char*>(newline) + 1;
+        }
+        return count;
+    }
+
+    // Function: parse
+    // Parses every line in [p, end). When arcs were pre-sized by the
+    // caller they are written in place, otherwise they are appended.
+    // Returns:
+    //   false on a malformed or out-of-range line, a negative capacity,
+    //   or a node or arc line before the problem line
+    // Time Complexity: O(bytes)
+    bool parse(const char* p, const char* end) {
+        while (p < end) {
+            if (!parseLine(p, end)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Function: finish
+    // Trims a pre-sized arc array to the arcs actually read
+    void finish() {
+        if (presized) {
+            network.arcs.resize(nextArc);
+        }
+    }
+
+    void presize(size_t arcCount) {
+        network.arcs.resize(arcCount);
+        presized = true;
+    }
+
+    bool sawProblemLine() const { return hasProblem; }
+    long long declaredArcs() const { return edges; }
+
+    // Function: complete
+    // True once a problem line was read and at least as many arcs as it
+    // declares; a shorter arc list is reported as a truncated instance
+    bool complete() const {
+        if (hasProblem && static_cast<unsigned long long>(nextArc) < static_cast<unsigned long long>(edges)) {
+            std::cerr << "Error: DIMACS instance has " << nextArc << " of the " << edges
+                      << " arcs declared by its problem line" << std::endl;
+            return false;
+        }
+        return hasProblem;
+    }
+
+    // Arcs reserved up front on the streaming path; the declared count
+    // is not trusted further than this before the arcs arrive
+    static constexpr size_t streamReserveArcs = size_t(1) << 20;
+
+private:
+    FlowNetwork& network;
+    size_t nextArc = 0;
+    long long edges = 0;
+    bool presized = false;
+    bool hasProblem = false;
+
+    static void skipBlanks(const char*& p, const char* end) {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) {
+            ++p;
+        }
+    }
+
+    // Reads a decimal integer; fails on a missing number or one that does
+    // not fit in a long long
+    static bool scanInteger(const char*& p, const char* end, long long& value) {
+        skipBlanks(p, end);
+        bool negative = false;
+        if (p < end && *p == '-') {
+            negative = true;
+            ++p;
+        }
+        if (p >= end || *p < '0' || *p > '9') {
+            return false;
+        }
+        long long result = 0;
+        while (p < end && *p >= '0' && *p <= '9') {
+            int digit = *p - '0';
+            if (result > (LLONG_MAX - digit) / 10) {
+                return false;
+            }
+            result = result * 10 + digit;
+            ++p;
+        }
+        value = negative ? -result : result;
+        return true;
+    }
+
+    bool parseLine(const char*& p, const char* end) {
+        const char* lineStart = p;
+        if (*p == '\n') {
+            ++p; // blank line
+            return true;
+        }
+        char type = *p++;
+        bool ok = true;
+        const char* error = "Malformed DIMACS line";
+
+        if ((type == 'n' || type == 'a') && !hasProblem) {
+            ok = false;
+            error = "DIMACS node or arc line before the problem line";
+        } else if (type == 'p') {
+            skipBlanks(p, end);
+            while (p < end && *p != ' ' && *p != '\t' && *p != '\n') {
+                ++p; // format word, e.g. "max"
+            }
+            long long nodes = 0;
+            ok = scanInteger(p, end, nodes) && scanInteger(p, end, edges) &&
+                 nodes >= 0 && nodes <= INT_MAX && edges >= 0;
+            network.nodes = ok ? static_cast<int>(nodes) : 0;
+            hasProblem = ok;
+            if (ok && !presized) {
+                network.arcs.reserve(edges < static_cast<long long>(streamReserveArcs)
+                                         ? static_cast<size_t>(edges) : streamReserveArcs);
+            }
+        } else if (type == 'n') {
+            long long nodeID = 0;
+            ok = scanInteger(p, end, nodeID) && nodeID >= 1 && nodeID <= network.nodes;
+            skipBlanks(p, end);
+            if (ok && p < end) {
+                if (*p == 's') {
+                    network.source = static_cast<int>(nodeID - 1);
+                } else if (*p == 't') {
+                    network.sink = static_cast<int>(nodeID - 1);
+                }
+            }
+        } else if (type == 'a') {
+            long long u = 0;
+            long long v = 0;
+            long long cap = 0;
+            ok = scanInteger(p, end, u) && scanInteger(p, end, v) && scanInteger(p, end, cap) &&
+                 u >= 1 && v >= 1 && u <= network.nodes && v <= network.nodes;
+            if (ok && cap < 0) {
+                ok = false;
+                error = "Negative capacity in DIMACS arc line";
+            }
+            if (ok) {
+                FlowArc arc{static_cast<int>(u - 1), static_cast<int>(v - 1), cap};
+                if (presized && nextArc < network.arcs.size()) {
+                    network.arcs[nextArc] = arc;
+                } else {
+                    network.arcs.push_back(arc);
+                }
+                ++nextArc;
+            }
+        }
+
+        const void* newline = std::memchr(p, '\n', static_cast<size_t>(end - p));
+        if (!ok) {
+            const char* lineEnd = newline ? static_cast<const char*>(newline) : end;
+            std::cerr << "Error: " << error << ": "
+                      << std::string(lineStart, lineEnd) << std::endl;
+            return false;
+        }
+        p = newline ? static_cast<const char*>(newline) + 1 : end;
+        return true;
+    }
+};
+
+// Function: readFlowNetworkStream
+// Fallback loader for stdin and pipes: single pass over a reusable
+// 1 MiB buffer, carrying a partial last line into the next read
+// Time Complexity: O(bytes)
+// Space Complexity: O(E)
+inline bool readFlowNetworkStream(std::FILE* in, DimacsParser& parser, DimacsLoadStats& stats) {
+    std::vector<char> buffer(1 << 20);
+    size_t carry = 0;
+
+    while (true) {
+        if (carry == buffer.size()) {
+            buffer.resize(buffer.size() * 2); // a single line longer than the buffer
+        }
+        size_t got = std::fread(buffer.data() + carry, 1, buffer.size() - carry, in);
+        stats.bytes += got;
+        size_t filled = carry + got;
+        if (got == 0) {
+            return parser.parse(buffer.data(), buffer.data() + filled);
+        }
+
+        const char* begin = buffer.data();
+        const char* lastNewline = begin + filled;
+        while (lastNewline > begin && lastNewline[-1] != '\n') {
+            --lastNewline;
+        }
+        if (!parser.parse(begin, lastNewline)) {
+            return false;
+        }
+        carry = static_cast<size_t>(begin + filled - lastNewline);
+        std::memmove(buffer.data(), lastNewline, carry);
+    }
+}
+
+// Function: readFlowNetwork
+// Reads a DIMACS max flow instance into a FlowNetwork arc list.
+// Regular files are memory-mapped and parsed in two passes; "-" reads
+// standard input and unmappable paths are streamed.
+// Parameters:
+// - filename, path to the input file, or "-" for stdin
+// - network, output instance
+// - stats, optional output with bytes parsed and elapsed time
+// Returns:
+//   true if the input was read, a problem line was found and no fewer
+//   arcs than it declares followed
+// Time Complexity: O(bytes)
+// Space Complexity: O(E)
+inline bool readFlowNetwork(const std::string& filename, FlowNetwork& network,
+                            DimacsLoadStats* stats = nullptr) {
+    auto started = std::chrono::steady_clock::now();
+    // Reset but keep the arc buffer, so a reused network only grows
+    network.nodes = 0;
+    network.source = -1;
+    network.sink = -1;
+    network.arcs.clear();
+    DimacsParser parser(network);
+    DimacsLoadStats local;
+    bool ok = false;
+
+    if (filename == "-") {
+        ok = readFlowNetworkStream(stdin, parser, local);
+    } else {
+        MappedFile mapped(filename);
+        if (mapped.data() != nullptr) {
+            const char* begin = mapped.data();
+            const char* end = begin + mapped.size();
+            local.mapped = true;
+            local.bytes = mapped.size();
+            parser.presize(DimacsParser::countArcs(begin, end));
+            ok = parser.parse(begin, end);
+        } else {
+            std::FILE* in = std::fopen(filename.c_str(), "rb");
+            if (in == nullptr) {
+                std::cerr << "Error: Could not open file " << filename << std::endl;
+                return false;
+            }
+            ok = readFlowNetworkStream(in, parser, local);
+            std::fclose(in);
+        }
+    }
+    parser.finish();
+
+    local.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    if (stats != nullptr) {
+        *stats = local;
+    }
+    return ok && parser.complete();
+}
+
+#endif
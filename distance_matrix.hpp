@@ -0,0 +1,389 @@
+/*
+    Distance Matrix
+    Description:
+    Contiguous row-major distance matrix for the TSP solvers. The element
+    type is int16_t, int32_t or float. The optional upper-triangular mode
+    stores each pair once, for symmetric inputs, and halves the memory.
+    Missing edges (0 or negative in the input, and the diagonal) are
+    stored as a sentinel (the largest value of the element type), so
+    "no edge" never needs its own branch.
+
+    argminMasked() is the nearest-unvisited kernel. It returns the first
+    j minimizing max(row[j], mask[j]), where mask[j] is 0 for unvisited
+    cities and the sentinel for visited ones. The AVX2 or SSE4.1 variant
+    is picked at runtime from the CPU, with a scalar fallback.
+*/
+
+#ifndef DISTANCE_MATRIX_HPP
+#define DISTANCE_MATRIX_HPP
+
+#include <iostream>
+#include <vector>
+#include <limits>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <type_traits>
+using namespace std;
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define DISTANCE_MATRIX_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define DISTANCE_TARGET(isa) __attribute__((target(isa)))
+#else
+#define DISTANCE_TARGET(isa)
+#endif
+
+/*
+    Class: DistanceMatrix
+    Description:
+    n x n distances of element type T. Length is the type used to sum a
+    tour: long long for integer elements, double for float.
+*/
+template <class T>
+class DistanceMatrix {
+    static_assert(is_same<T, int16_t>::value || is_same<T, int32_t>::value || is_same<T, float>::value,
+                  "DistanceMatrix supports int16_t, int32_t and float");
+
+public:
+    typedef T Value;
+    typedef typename conditional<is_floating_point<T>::value, double, long long>::type Length;
+
+    DistanceMatrix() {}
+
+    // Constructor: DistanceMatrix
+    // Parameters:
+    // - n, number of cities; every pair starts as a missing edge
+    // - triangular, store only i <= j; set(i, j) then also sets (j, i)
+    DistanceMatrix(int n, bool triangular = false) : n(n), triangular(triangular) {
+        size_t cells = triangular ? (size_t)n * (n + 1) / 2 : (size_t)n * n;
+        values.assign(cells, none());
+    }
+
+    // Function: resize
+    // Same as constructing a new matrix, but keeps the allocation so a
+    // reused matrix only grows
+    void resize(int size, bool triangularStorage = false) {
+        n = size;
+        triangular = triangularStorage;
+        values.assign(triangular ? (size_t)n * (n + 1) / 2 : (size_t)n * n, none());
+    }
+
+    // Sentinel for missing edges and visited cities
+    static T none() { return numeric_limits<T>::max(); }
+
+    int size() const { return n; }
+    bool isTriangular() const { return triangular; }
+    size_t bytes() const { return values.size() * sizeof(T); }
+
+    T at(int i, int j) const { return values[index(i, j)]; }
+
+    // Function: set
+    // Stores w for (i, j); w <= 0 or i == j means no edge
+    void set(int i, int j, T w) { values[index(i, j)] = i == j || w <= 0 ? none() : w; }
+
+    /*
+        Function: row
+        Description:
+        Contiguous view of row i. Full matrices return the stored row;
+        triangular ones gather it into scratch first.
+    */
+    const T *row(int i, vector<T> &scratch) const {
+        if (!triangular) {
+            return &values[(size_t)i * n];
+        }
+        scratch.resize(n);
+        for (int j = 0; j < i; j++) {
+            scratch[j] = values[index(j, i)];
+        }
+        memcpy(&scratch[i], &values[index(i, i)], (n - i) * sizeof(T));
+        return scratch.data();
+    }
+
+private:
+    int n = 0;
+    bool triangular = false;
+    vector<T> values;
+
+    size_t index(int i, int j) const {
+        if (!triangular) {
+            return (size_t)i * n + j;
+        }
+        if (i > j) {
+            swap(i, j);
+        }
+        return (size_t)i * n - (size_t)i * (i - 1) / 2 + (j - i);
+    }
+};
+
+/*
+    Function: readDistanceMatrix
+    Description:
+    Reads "n" followed by n * n distances (the graph.txt / input.txt
+    layout). In triangular mode only the entries with i <= j are kept.
+
+    Return value:
+    true on success; false on a short read, or on a negative distance or
+    one the element type cannot hold below its none() sentinel
+*/
+template <class T>
+bool readDistanceMatrix(istream &in, DistanceMatrix<T> &matrix, bool triangular = false) {
+    int n;
+    if (!(in >> n) || n < 0) {
+        cerr << "Error: missing matrix size\n";
+        return false;
+    }
+    matrix.resize(n, triangular);
+    typedef typename conditional<is_floating_point<T>::value, double, long long>::type Input;
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            Input w;
+            if (!(in >> w)) {
+                cerr << "Error: matrix ends at row " << i << ", column " << j << "\n";
+                return false;
+            }
+            // Checked before the narrowing cast, which would wrap it
+            if (!(w >= 0) || w >= (Input)DistanceMatrix<T>::none()) {
+                cerr << "Error: distance " << w << " is outside 0.." << (Input)DistanceMatrix<T>::none() - 1
+                     << " for the matrix element type\n";
+                return false;
+            }
+            if (!triangular || i <= j) {
+                matrix.set(i, j, (T)w);
+            }
+        }
+    }
+    return true;
+}
+
+enum class SimdLevel {
+    Scalar,
+    SSE41,
+    AVX2
+};
+
+/*
+    Function: detectSimdLevel
+    Description:
+    Best instruction set the kernels can use on this CPU, checked once.
+*/
+inline SimdLevel detectSimdLevel() {
+    static const SimdLevel level = [] {
+#if defined(DISTANCE_MATRIX_X86) && (defined(__GNUC__) || defined(__clang__))
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) return SimdLevel::AVX2;
+        if (__builtin_cpu_supports("sse4.1")) return SimdLevel::SSE41;
+#elif defined(DISTANCE_MATRIX_X86) && defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0);
+        int maxLeaf = info[0];
+        __cpuid(info, 1);
+        bool sse41 = (info[2] >> 19) & 1;
+        bool osAvx = ((info[2] >> 27) & 1) && ((info[2] >> 28) & 1) && (_xgetbv(0) & 6) == 6;
+        if (osAvx && maxLeaf >= 7) {
+            __cpuidex(info, 7, 0);
+            if ((info[1] >> 5) & 1) return SimdLevel::AVX2;
+        }
+        if (sse41) return SimdLevel::SSE41;
+#endif
+        return SimdLevel::Scalar;
+    }();
+    return level;
+}
+
+inline int lowestSetBit(unsigned bits) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward(&index, bits);
+    return (int)index;
+#else
+    return __builtin_ctz(bits);
+#endif
+}
+
+template <class T>
+int argminMaskedScalar(const T *row, const T *mask, int n) {
+    T best = DistanceMatrix<T>::none();
+    int arg = -1;
+    for (int j = 0; j < n; j++) {
+        T v = max(row[j], mask[j]);
+        if (v < best) {
+            best = v;
+            arg = j;
+        }
+    }
+    return arg;
+}
+
+#ifdef DISTANCE_MATRIX_X86
+
+/*
+    Per-type vector operations. equal() returns one bit per byte, so the
+    matching lane is lowestSetBit / sizeof(T).
+*/
+template <class T> struct Avx2Lanes;
+template <class T> struct Sse41Lanes;
+
+template <> struct Avx2Lanes<int32_t> {
+    typedef __m256i V;
+    DISTANCE_TARGET("avx2") static V load(const int32_t *p) { return _mm256_loadu_si256((const __m256i *)p); }
+    DISTANCE_TARGET("avx2") static V splat(int32_t x) { return _mm256_set1_epi32(x); }
+    DISTANCE_TARGET("avx2") static V vmin(V a, V b) { return _mm256_min_epi32(a, b); }
+    DISTANCE_TARGET("avx2") static V vmax(V a, V b) { return _mm256_max_epi32(a, b); }
+    DISTANCE_TARGET("avx2") static unsigned equal(V a, V b) { return (unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi32(a, b)); }
+};
+
+template <> struct Avx2Lanes<int16_t> {
+    typedef __m256i V;
+    DISTANCE_TARGET("avx2") static V load(const int16_t *p) { return _mm256_loadu_si256((const __m256i *)p); }
+    DISTANCE_TARGET("avx2") static V splat(int16_t x) { return _mm256_set1_epi16(x); }
+    DISTANCE_TARGET("avx2") static V vmin(V a, V b) { return _mm256_min_epi16(a, b); }
+    DISTANCE_TARGET("avx2") static V vmax(V a, V b) { return _mm256_max_epi16(a, b); }
+    DISTANCE_TARGET("avx2") static unsigned equal(V a, V b) { return (unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi16(a, b)); }
+};
+
+template <> struct Avx2Lanes<float> {
+    typedef __m256 V;
+    DISTANCE_TARGET("avx2") static V load(const float *p) { return _mm256_loadu_ps(p); }
+    DISTANCE_TARGET("avx2") static V splat(float x) { return _mm256_set1_ps(x); }
+    DISTANCE_TARGET("avx2") static V vmin(V a, V b) { return _mm256_min_ps(a, b); }
+    DISTANCE_TARGET("avx2") static V vmax(V a, V b) { return _mm256_max_ps(a, b); }
+    DISTANCE_TARGET("avx2") static unsigned equal(V a, V b) {
+        return (unsigned)_mm256_movemask_epi8(_mm256_castps_si256(_mm256_cmp_ps(a, b, _CMP_EQ_OQ)));
+    }
+};
+
+template <> struct Sse41Lanes<int32_t> {
+    typedef __m128i V;
+    DISTANCE_TARGET("sse4.1") static V load(const int32_t *p) { return _mm_loadu_si128((const __m128i *)p); }
+    DISTANCE_TARGET("sse4.1") static V splat(int32_t x) { return _mm_set1_epi32(x); }
+    DISTANCE_TARGET("sse4.1") static V vmin(V a, V b) { return _mm_min_epi32(a, b); }
+    DISTANCE_TARGET("sse4.1") static V vmax(V a, V b) { return _mm_max_epi32(a, b); }
+    DISTANCE_TARGET("sse4.1") static unsigned equal(V a, V b) { return (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi32(a, b)); }
+};
+
+template <> struct Sse41Lanes<int16_t> {
+    typedef __m128i V;
+    DISTANCE_TARGET("sse4.1") static V load(const int16_t *p) { return _mm_loadu_si128((const __m128i *)p); }
+    DISTANCE_TARGET("sse4.1") static V splat(int16_t x) { return _mm_set1_epi16(x); }
+    DISTANCE_TARGET("sse4.1") static V vmin(V a, V b) { return _mm_min_epi16(a, b); }
+    DISTANCE_TARGET("sse4.1") static V vmax(V a, V b) { return _mm_max_epi16(a, b); }
+    DISTANCE_TARGET("sse4.1") static unsigned equal(V a, V b) { return (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi16(a, b)); }
+};
+
+template <> struct Sse41Lanes<float> {
+    typedef __m128 V;
+    DISTANCE_TARGET("sse4.1") static V load(const float *p) { return _mm_loadu_ps(p); }
+    DISTANCE_TARGET("sse4.1") static V splat(float x) { return _mm_set1_ps(x); }
+    DISTANCE_TARGET("sse4.1") static V vmin(V a, V b) { return _mm_min_ps(a, b); }
+    DISTANCE_TARGET("sse4.1") static V vmax(V a, V b) { return _mm_max_ps(a, b); }
+    DISTANCE_TARGET("sse4.1") static unsigned equal(V a, V b) {
+        return (unsigned)_mm_movemask_epi8(_mm_castps_si128(_mm_cmpeq_ps(a, b)));
+    }
+};
+
+/*
+    The two SIMD kernels share one shape: a vertical min of
+    max(row, mask) across the row, a horizontal reduce, then a second
+    pass for the first lane equal to the minimum. They are written out
+    per instruction set because each needs its own target attribute.
+*/
+template <class T>
+DISTANCE_TARGET("avx2") int argminMaskedAvx2(const T *row, const T *mask, int n) {
+    typedef Avx2Lanes<T> L;
+    const int lanes = (int)(sizeof(typename L::V) / sizeof(T));
+    const T none = DistanceMatrix<T>::none();
+    typename L::V best = L::splat(none);
+    int j = 0;
+    for (; j + lanes <= n; j += lanes) {
+        best = L::vmin(best, L::vmax(L::load(row + j), L::load(mask + j)));
+    }
+    alignas(32) T lane[32 / sizeof(T)];
+    memcpy(lane, &best, sizeof best);
+    T value = none;
+    for (int k = 0; k < lanes; k++) value = min(value, lane[k]);
+    for (int k = j; k < n; k++) value = min(value, max(row[k], mask[k]));
+    if (value == none) {
+        return -1;
+    }
+    typename L::V target = L::splat(value);
+    for (j = 0; j + lanes <= n; j += lanes) {
+        unsigned bits = L::equal(L::vmax(L::load(row + j), L::load(mask + j)), target);
+        if (bits) {
+            return j + lowestSetBit(bits) / (int)sizeof(T);
+        }
+    }
+    for (; j < n; j++) {
+        if (max(row[j], mask[j]) == value) return j;
+    }
+    return -1;
+}
+
+template <class T>
+DISTANCE_TARGET("sse4.1") int argminMaskedSse41(const T *row, const T *mask, int n) {
+    typedef Sse41Lanes<T> L;
+    const int lanes = (int)(sizeof(typename L::V) / sizeof(T));
+    const T none = DistanceMatrix<T>::none();
+    typename L::V best = L::splat(none);
+    int j = 0;
+    for (; j + lanes <= n; j += lanes) {
+        best = L::vmin(best, L::vmax(L::load(row + j), L::load(mask + j)));
+    }
+    alignas(16) T lane[16 / sizeof(T)];
+    memcpy(lane, &best, sizeof best);
+    T value = none;
+    for (int k = 0; k < lanes; k++) value = min(value, lane[k]);
+    for (int k = j; k < n; k++) value = min(value, max(row[k], mask[k]));
+    if (value == none) {
+        return -1;
+    }
+    typename L::V target = L::splat(value);
+    for (j = 0; j + lanes <= n; j += lanes) {
+        unsigned bits = L::equal(L::vmax(L::load(row + j), L::load(mask + j)), target);
+        if (bits) {
+            return j + lowestSetBit(bits) / (int)sizeof(T);
+        }
+    }
+    for (; j < n; j++) {
+        if (max(row[j], mask[j]) == value) return j;
+    }
+    return -1;
+}
+
+#endif
+
+/*
+    Function: argminMasked
+    Description:
+    Index of the nearest unvisited city in a row, ties going to the
+    lowest index. Rows hold the sentinel for missing edges and mask
+    holds it for visited cities, so both drop out of the minimum.
+
+    Parameters:
+    row: n distances
+    mask: n entries, 0 = unvisited, DistanceMatrix<T>::none() = visited
+    n: row length
+    level: instruction set (defaults to the best one available)
+
+    Return value:
+    The index, or -1 if no unvisited city is reachable
+
+    Time Complexity: O(n)
+*/
+template <class T>
+int argminMasked(const T *row, const T *mask, int n, SimdLevel level = detectSimdLevel()) {
+#ifdef DISTANCE_MATRIX_X86
+    if (level == SimdLevel::AVX2) return argminMaskedAvx2(row, mask, n);
+    if (level == SimdLevel::SSE41) return argminMaskedSse41(row, mask, n);
+#endif
+    (void)level;
+    return argminMaskedScalar(row, mask, n);
+}
+
+#endif
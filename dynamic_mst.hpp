@@ -0,0 +1,329 @@
+// Dynamic MST maintenance with link-cut trees
+#ifndef DYNAMIC_MST_HPP
+#define DYNAMIC_MST_HPP
+
+#include <iostream>
+#include <vector>
+#include <climits>
+#include <algorithm>
+#include "kruskal.hpp"
+using namespace std;
+
+// Class: LinkCutTree
+// Forest of splay-tree paths supporting link, cut and path-maximum
+// queries in O(log n) amortized. Node 0 is a null sentinel, so real
+// nodes start at 1. Each node carries a value; best[] holds the node
+// with the largest value in its splay subtree.
+class LinkCutTree {
+    vector<int> left, right, parent, best;
+    vector<long long> value;
+    vector<char> flipped;
+
+    bool isRoot(int x) const {
+        int p = parent[x];
+        return p == 0 || (left[p] != x && right[p] != x);
+    }
+
+    int better(int a, int b) const {
+        if (a == 0) return b;
+        if (b == 0) return a;
+        return value[a] >= value[b] ? a : b;
+    }
+
+    void update(int x) {
+        best[x] = better(better(best[left[x]], best[right[x]]), x);
+    }
+
+    void push(int x) {
+        if (!flipped[x]) return;
+        swap(left[x], right[x]);
+        if (left[x]) flipped[left[x]] ^= 1;
+        if (right[x]) flipped[right[x]] ^= 1;
+        flipped[x] = 0;
+    }
+
+    void rotate(int x) {
+        int p = parent[x], g = parent[p];
+        bool pRoot = isRoot(p);
+        if (left[p] == x) {
+            left[p] = right[x];
+            if (right[x]) parent[right[x]] = p;
+            right[x] = p;
+        } else {
+            right[p] = left[x];
+            if (left[x]) parent[left[x]] = p;
+            left[x] = p;
+        }
+        parent[p] = x;
+        parent[x] = g;
+        if (!pRoot) {
+            if (left[g] == p) left[g] = x;
+            else right[g] = x;
+        }
+        update(p);
+        update(x);
+    }
+
+    void splay(int x) {
+        // Push pending reversals from the top of the splay tree down
+        static thread_local vector<int> stack;
+        stack.clear();
+        for (int y = x;; y = parent[y]) {
+            stack.push_back(y);
+            if (isRoot(y)) break;
+        }
+        for (int i = (int)stack.size() - 1; i >= 0; i--) push(stack[i]);
+
+        while (!isRoot(x)) {
+            int p = parent[x], g = parent[p];
+            if (!isRoot(p)) rotate((left[g] == p) == (left[p] == x) ? p : x);
+            rotate(x);
+        }
+    }
+
+    void access(int x) {
+        for (int last = 0, y = x; y; last = y, y = parent[y]) {
+            splay(y);
+            right[y] = last;
+            update(y);
+        }
+        splay(x);
+    }
+
+    void makeRoot(int x) {
+        access(x);
+        flipped[x] ^= 1;
+    }
+
+    int findRoot(int x) {
+        access(x);
+        while (true) {
+            push(x);
+            if (!left[x]) break;
+            x = left[x];
+        }
+        splay(x);
+        return x;
+    }
+
+public:
+    // Function: addNode
+    // Returns:
+    // - index of a new isolated node with the given value
+    int addNode(long long v) {
+        if (left.empty()) {
+            left.push_back(0), right.push_back(0), parent.push_back(0), best.push_back(0);
+            value.push_back(LLONG_MIN), flipped.push_back(0);
+        }
+        left.push_back(0), right.push_back(0), parent.push_back(0);
+        value.push_back(v), flipped.push_back(0);
+        best.push_back((int)value.size() - 1);
+        return (int)value.size() - 1;
+    }
+
+    // Function: setValue
+    // Time Complexity: O(log n) amortized
+    void setValue(int x, long long v) {
+        access(x);
+        value[x] = v;
+        update(x);
+    }
+
+    bool connected(int x, int y) {
+        return x == y || findRoot(x) == findRoot(y);
+    }
+
+    void link(int x, int y) {
+        makeRoot(x);
+        parent[x] = y;
+    }
+
+    // Function: cut
+    // Removes the tree edge between adjacent nodes x and y
+    void cut(int x, int y) {
+        makeRoot(x);
+        access(y);
+        // x is now y's left child with no right subtree of its own
+        left[y] = 0;
+        parent[x] = 0;
+        update(y);
+    }
+
+    // Function: pathMax
+    // Returns:
+    // - node with the largest value on the path x .. y (same tree)
+    int pathMax(int x, int y) {
+        makeRoot(x);
+        access(y);
+        return best[y];
+    }
+
+    long long valueOf(int x) const { return value[x]; }
+};
+
+// Class: DynamicMST
+// Keeps a minimum spanning forest under edge insertions and weight
+// changes. Every edge is its own link-cut node placed between its two
+// endpoints, so the heaviest edge on a tree path is a path-max query.
+// Inserting (or lowering) an edge u-v of weight w either links two
+// components, or swaps out the heaviest edge on the u..v cycle when it
+// is heavier than w.
+class DynamicMST {
+    LinkCutTree lct;
+    int vertices;
+    vector<FlatEdge> edges;
+    vector<int> node;        // edge id -> link-cut node
+    vector<int> edgeOf;      // link-cut node -> edge id, -1 for vertices
+    vector<char> inTree;
+    long long cost = 0;
+    size_t treeSize = 0;
+
+    void attach(int id) {
+        const FlatEdge &e = edges[id];
+        lct.link(e.u + 1, node[id]);
+        lct.link(node[id], e.v + 1);
+        inTree[id] = 1;
+        cost += e.w;
+        treeSize++;
+    }
+
+    void detach(int id) {
+        const FlatEdge &e = edges[id];
+        lct.cut(e.u + 1, node[id]);
+        lct.cut(node[id], e.v + 1);
+        inTree[id] = 0;
+        cost -= e.w;
+        treeSize--;
+    }
+
+    // Function: offer
+    // Tries to bring non-tree edge id into the forest
+    // Time Complexity: O(log V) amortized
+    void offer(int id) {
+        const FlatEdge &e = edges[id];
+        if (e.u == e.v) return;
+        int a = e.u + 1, b = e.v + 1;
+        if (!lct.connected(a, b)) {
+            attach(id);
+            return;
+        }
+        int heaviest = edgeOf[lct.pathMax(a, b)];
+        if (heaviest >= 0 && edges[heaviest].w > e.w) {
+            detach(heaviest);
+            attach(id);
+        }
+    }
+
+public:
+    // Constructor: DynamicMST
+    // Seeds the structure with a set of edges, typically a spanning forest
+    // such as the edges returned by kruskalsMST / kruskalsMSTFlat. Each
+    // seed goes through the same offer() as insertEdge, so a seed with
+    // cycles still yields its minimum spanning forest.
+    // Only the seed and inserted edges are known. Raising a tree edge
+    // looks for a replacement among them alone, so when seeded with just
+    // a graph's MST, totalCost() can drift above the MST of the full
+    // graph once tree edges get heavier. Seed with every graph edge when
+    // raises must stay exact.
+    // Parameters:
+    // - V, number of vertices
+    // - seedEdges, initial edges; the valid ones get edge ids 0 .. k-1 in
+    //   order, and edges with an endpoint outside 0 .. V-1 are reported
+    //   and skipped
+    // Time Complexity: O((V + k) log V)
+    DynamicMST(int V, const vector<FlatEdge> &seedEdges) : vertices(max(V, 0)) {
+        for (int v = 0; v < vertices; v++) {
+            lct.addNode(LLONG_MIN);
+            edgeOf.push_back(-1);
+        }
+        edgeOf.insert(edgeOf.begin(), -1); // sentinel node 0
+        for (const auto &e : seedEdges) {
+            if (e.u >= (uint32_t)vertices || e.v >= (uint32_t)vertices) {
+                cerr << "Error: seed edge " << e.u << "-" << e.v << " is outside 0.." << vertices - 1 << "\n";
+                continue;
+            }
+            offer(newEdge(e));
+        }
+    }
+
+    // Function: insertEdge
+    // Adds edge u-v with weight w and updates the forest
+    // Returns:
+    // - edge id for later weight changes, or -1 (nothing added) if u or v
+    //   is not a vertex
+    // Time Complexity: O(log V) amortized
+    int insertEdge(int u, int v, int w) {
+        if (u < 0 || v < 0 || u >= vertices || v >= vertices) {
+            cerr << "Error: edge " << u << "-" << v << " is outside 0.." << vertices - 1 << "\n";
+            return -1;
+        }
+        int id = newEdge({(uint32_t)u, (uint32_t)v, w});
+        offer(id);
+        return id;
+    }
+
+    // Function: setWeight
+    // Changes the weight of edge id. Lowering a weight, or raising a
+    // non-tree edge, costs O(log V). Raising a tree edge needs the
+    // lightest replacement across the cut, which this structure cannot
+    // find in polylog time; it falls back to one O(E log V) pass over the
+    // known non-tree edges.
+    // Returns:
+    // - false (nothing changed) if id is not an edge id
+    bool setWeight(int id, int w) {
+        if (id < 0 || id >= (int)edges.size()) {
+            cerr << "Error: unknown edge id " << id << "\n";
+            return false;
+        }
+        FlatEdge &e = edges[id];
+        int old = e.w;
+        if (inTree[id]) {
+            cost += (long long)w - old;
+            e.w = w;
+            lct.setValue(node[id], w);
+            if (w > old) {
+                detach(id);
+                offer(id);
+                for (int other = 0; other < (int)edges.size(); other++) {
+                    if (!inTree[other]) offer(other);
+                }
+            }
+            return true;
+        }
+        e.w = w;
+        lct.setValue(node[id], w);
+        if (w < old) offer(id);
+        return true;
+    }
+
+    // Function: totalCost
+    // Total weight of the current forest
+    long long totalCost() const { return cost; }
+
+    // Function: treeEdges
+    // Current forest edges
+    // Time Complexity: O(E)
+    vector<FlatEdge> treeEdges() const {
+        vector<FlatEdge> result;
+        result.reserve(treeSize);
+        for (size_t id = 0; id < edges.size(); id++) {
+            if (inTree[id]) result.push_back(edges[id]);
+        }
+        return result;
+    }
+
+    bool isTreeEdge(int id) const { return id >= 0 && id < (int)edges.size() && inTree[id]; }
+    int vertexCount() const { return vertices; }
+
+private:
+    int newEdge(const FlatEdge &e) {
+        int id = (int)edges.size();
+        edges.push_back(e);
+        inTree.push_back(0);
+        node.push_back(lct.addNode(e.w));
+        edgeOf.push_back(id);
+        return id;
+    }
+};
+
+#endif
@@ -0,0 +1,334 @@
+/*
+    Edge-list input and external-memory MST
+    Description:
+    Reads sparse graphs as text ("V E" header, then one "u v w" line per
+    edge, 0-based) or as a binary file (magic "MSTB", uint32 V, uint64 E,
+    then E packed FlatEdge records). Headers that promise more edges
+    than the file can hold, endpoints outside 0..V-1 and malformed or
+    missing edges are rejected. externalKruskalMST() handles edge
+    sets larger than RAM: it cuts the input into runs that fit in a
+    memory budget, radix-sorts each run and spills it to a temporary
+    file, then k-way merges the runs into a DSU. Only the O(V) DSU, the
+    MST itself and fixed-size read buffers stay resident.
+*/
+
+#ifndef EXTERNAL_MST_HPP
+#define EXTERNAL_MST_HPP
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <queue>
+#include <functional>
+#include <climits>
+#include <filesystem>
+#include "kruskal.hpp"
+using namespace std;
+
+inline constexpr char binaryEdgeMagic[4] = {'M', 'S', 'T', 'B'};
+
+/*
+    Class: EdgeListReader
+    Description:
+    Sequential reader over a text or binary edge list with one reusable
+    buffer; the format is detected from the first four bytes. Once an
+    invalid header or edge is seen, good() turns false and read()
+    returns nothing more.
+*/
+class EdgeListReader {
+public:
+    EdgeListReader(const string &filename, size_t bufferBytes = 1 << 20) : buffer(bufferBytes) {
+        file = fopen(filename.c_str(), "rb");
+        if (!file) {
+            cerr << "Error: could not open file " << filename << "\n";
+            return;
+        }
+        error_code sizeError;
+        uint64_t bytes = filesystem::file_size(filename, sizeError);
+        char magic[4];
+        if (fread(magic, 1, 4, file) == 4 && memcmp(magic, binaryEdgeMagic, 4) == 0) {
+            binary = true;
+            uint32_t v = 0;
+            uint64_t e = 0;
+            ok = fread(&v, sizeof v, 1, file) == 1 && fread(&e, sizeof e, 1, file) == 1 && v <= INT_MAX;
+            vertices = (int)v;
+            edges = e;
+            // The records must fill the rest of the file exactly
+            const uint64_t headerBytes = 4 + sizeof v + sizeof e;
+            if (ok && !sizeError && (bytes < headerBytes || e != (bytes - headerBytes) / sizeof(FlatEdge) ||
+                                     (bytes - headerBytes) % sizeof(FlatEdge) != 0)) {
+                fail("edge count does not match the file size");
+                return;
+            }
+        } else {
+            fseek(file, 0, SEEK_SET);
+            long long v = 0, e = 0;
+            ok = scan(v) && scan(e) && v >= 0 && v <= INT_MAX && e >= 0;
+            vertices = (int)v;
+            edges = (uint64_t)e;
+            // Every text edge takes at least 6 bytes ("0 0 0\n"), the last one 5
+            if (ok && !sizeError && (uint64_t)e > (bytes + 1) / 6) {
+                fail("edge count does not match the file size");
+                return;
+            }
+        }
+        if (!ok) {
+            fail("malformed header");
+        }
+    }
+
+    ~EdgeListReader() {
+        if (file) fclose(file);
+    }
+
+    EdgeListReader(const EdgeListReader &) = delete;
+    EdgeListReader &operator=(const EdgeListReader &) = delete;
+
+    bool good() const { return file && ok; }
+    int vertexCount() const { return vertices; }
+    uint64_t edgeCount() const { return edges; }
+
+    // Function: read
+    // Fills out with up to max edges, never past the header's edge count.
+    // An edge that does not parse or has an endpoint outside 0..V-1
+    // stops the reader: the edges before it are returned and good()
+    // becomes false.
+    // Returns:
+    // - number of edges read (0 at the end of the input or after an error)
+    size_t read(FlatEdge *out, size_t max) {
+        if (!good()) return 0;
+        max = (size_t)min<uint64_t>(max, edges - consumed);
+        size_t n = 0;
+        if (binary) {
+            n = fread(out, sizeof(FlatEdge), max, file);
+            consumed += n;
+            for (size_t i = 0; i < n; i++) {
+                if (out[i].u >= (uint32_t)vertices || out[i].v >= (uint32_t)vertices) {
+                    fail("edge endpoint out of range");
+                    return i;
+                }
+            }
+            return n;
+        }
+        long long u, v, w;
+        while (n < max) {
+            if (!scan(u)) {
+                if (peek() != -1) fail("malformed edge");
+                break;
+            }
+            if (!scan(v) || !scan(w) || w < INT32_MIN || w > INT32_MAX) {
+                fail("malformed edge");
+                break;
+            }
+            if (u < 0 || v < 0 || u >= vertices || v >= vertices) {
+                fail("edge endpoint out of range");
+                break;
+            }
+            out[n++] = {(uint32_t)u, (uint32_t)v, (int32_t)w};
+        }
+        consumed += n;
+        return n;
+    }
+
+private:
+    FILE *file = nullptr;
+    bool binary = false;
+    bool ok = false;
+    int vertices = 0;
+    uint64_t edges = 0;
+    uint64_t consumed = 0;
+    vector<char> buffer;
+    size_t pos = 0, len = 0;
+
+    void fail(const char *message) {
+        cerr << "Error: " << message << " in edge list\n";
+        ok = false;
+    }
+
+    int peek() {
+        if (pos == len) {
+            len = fread(buffer.data(), 1, buffer.size(), file);
+            pos = 0;
+            if (len == 0) return -1;
+        }
+        return (unsigned char)buffer[pos];
+    }
+
+    bool scan(long long &value) {
+        int c = peek();
+        while (c == ' ' || c == '\n' || c == '\r' || c == '\t') {
+            pos++;
+            c = peek();
+        }
+        bool negative = c == '-';
+        if (negative) {
+            pos++;
+            c = peek();
+        }
+        if (c < '0' || c > '9') return false;
+        long long result = 0;
+        while (c >= '0' && c <= '9') {
+            if (result > (LLONG_MAX - (c - '0')) / 10) return false;
+            result = result * 10 + (c - '0');
+            pos++;
+            c = peek();
+        }
+        value = negative ? -result : result;
+        return true;
+    }
+};
+
+/*
+    Function: writeBinaryEdgeList
+    Description:
+    Writes edges in the binary format read by EdgeListReader.
+
+    Return value:
+    true on success
+*/
+inline bool writeBinaryEdgeList(const string &filename, int V, const vector<FlatEdge> &edges) {
+    FILE *out = fopen(filename.c_str(), "wb");
+    if (!out) return false;
+    uint32_t v = (uint32_t)V;
+    uint64_t e = edges.size();
+    bool ok = fwrite(binaryEdgeMagic, 1, 4, out) == 4 && fwrite(&v, sizeof v, 1, out) == 1 &&
+              fwrite(&e, sizeof e, 1, out) == 1 &&
+              fwrite(edges.data(), sizeof(FlatEdge), edges.size(), out) == edges.size();
+    return fclose(out) == 0 && ok;
+}
+
+/*
+    Function: readEdgeList
+    Description:
+    Loads a whole text or binary edge list into memory. The header's
+    edge count is checked against the file size before anything is
+    allocated.
+
+    Return value:
+    true if the header and exactly the declared number of valid edges
+    were read
+*/
+inline bool readEdgeList(const string &filename, int &V, vector<FlatEdge> &edges) {
+    EdgeListReader reader(filename);
+    if (!reader.good()) return false;
+    V = reader.vertexCount();
+    edges.resize(reader.edgeCount());
+    edges.resize(reader.read(edges.data(), edges.size()));
+    if (!reader.good()) return false;
+    if (edges.size() != reader.edgeCount()) {
+        cerr << "Error: edge list " << filename << " is truncated\n";
+        return false;
+    }
+    return true;
+}
+
+/*
+    Function: externalKruskalMST
+    Description:
+    Kruskal over an edge file of any size.
+    1. Read runs of half the budget, radix-sort each and
+       spill it to a temporary file. A single run never touches disk.
+    2. Merge the runs with a min-heap of run heads. Each run has a
+       read buffer that is an equal share of the budget. Merged edges
+       go straight into the DSU, stopping at V - 1 tree edges.
+
+    Parameters:
+    filename: text or binary edge list
+    memoryBudget: bytes allowed for edge runs and merge buffers
+    V: output, number of vertices from the header
+
+    Return value:
+    A pair containing the total cost and the MST edges; {0, {}} if the
+    file is invalid or truncated
+
+    Time Complexity: O(E log k) with k = E * 12 / memoryBudget runs
+    Space Complexity: O(V + memoryBudget) in memory, O(E) on disk
+*/
+inline pair<long long, vector<FlatEdge>> externalKruskalMST(const string &filename, size_t memoryBudget, int &V) {
+    EdgeListReader reader(filename);
+    V = reader.good() ? reader.vertexCount() : 0;
+    if (!reader.good()) return {0, {}};
+
+    // The radix sort needs a second run-sized buffer: runs get half the budget
+    size_t runEdges = max<size_t>(memoryBudget / 2 / sizeof(FlatEdge), 1024);
+    vector<FlatEdge> run(runEdges);
+    vector<FILE *> spills;
+
+    size_t got = reader.read(run.data(), runEdges);
+    uint64_t total = got;
+    run.resize(got);
+    radixSortEdges(run);
+    if (got == runEdges) {
+        // More than one run: spill this one and every following run
+        while (!run.empty()) {
+            FILE *spill = tmpfile();
+            if (!spill || fwrite(run.data(), sizeof(FlatEdge), run.size(), spill) != run.size()) {
+                cerr << "Error: could not write temporary run\n";
+                for (FILE *f : spills) fclose(f);
+                if (spill) fclose(spill);
+                return {0, {}};
+            }
+            rewind(spill);
+            spills.push_back(spill);
+            run.resize(runEdges);
+            run.resize(reader.read(run.data(), runEdges));
+            total += run.size();
+            radixSortEdges(run);
+        }
+        vector<FlatEdge>().swap(run);
+    }
+    if (!reader.good() || total != reader.edgeCount()) {
+        if (reader.good()) cerr << "Error: edge list " << filename << " is truncated\n";
+        for (FILE *f : spills) fclose(f);
+        return {0, {}};
+    }
+
+    DSU dsu(V);
+    long long cost = 0;
+    vector<FlatEdge> mstEdges;
+    mstEdges.reserve(V > 0 ? V - 1 : 0);
+    auto take = [&](const FlatEdge &e) {
+        int x = dsu.find(e.u), y = dsu.find(e.v);
+        if (x == y) return;
+        dsu.unite(x, y);
+        cost += e.w;
+        mstEdges.push_back(e);
+    };
+
+    if (spills.empty()) {
+        for (const auto &e : run) {
+            if ((int)mstEdges.size() == V - 1) break;
+            take(e);
+        }
+        return {cost, mstEdges};
+    }
+
+    // k-way merge; each run streams through its own buffer
+    size_t k = spills.size();
+    size_t perRun = max<size_t>(memoryBudget / sizeof(FlatEdge) / k, 256);
+    vector<vector<FlatEdge>> buffers(k, vector<FlatEdge>(perRun));
+    vector<size_t> pos(k, 0), len(k, 0);
+    auto refill = [&](size_t r) {
+        len[r] = fread(buffers[r].data(), sizeof(FlatEdge), perRun, spills[r]);
+        pos[r] = 0;
+        return len[r] > 0;
+    };
+
+    typedef pair<int32_t, size_t> Head; // (weight, run)
+    priority_queue<Head, vector<Head>, greater<Head>> heap;
+    for (size_t r = 0; r < k; r++) {
+        if (refill(r)) heap.push({buffers[r][0].w, r});
+    }
+    while (!heap.empty() && (int)mstEdges.size() < V - 1) {
+        size_t r = heap.top().second;
+        heap.pop();
+        take(buffers[r][pos[r]]);
+        if (++pos[r] < len[r] || refill(r)) heap.push({buffers[r][pos[r]].w, r});
+    }
+
+    for (FILE *f : spills) fclose(f);
+    return {cost, mstEdges};
+}
+
+#endif
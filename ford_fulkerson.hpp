@@ -1,102 +1,84 @@
+#ifndef FORD_FULKERSON_HPP
+#define FORD_FULKERSON_HPP
+
 #include <iostream>
 #include <fstream>
 #include <string>
 #include <vector>
-#include <sstream>
 #include <queue>
 #include <climits>
+#include <cstdint>
+#include <algorithm>
+#include <atomic>
+#include "dimacs_loader.hpp"
+#include "thread_pool.hpp"
+#include "instrumentation.hpp"
 
-// Structure: Edge
-// Represents an edge in the graph with a destination node and capacity
-struct Edge {
-    int to;
-    int capacity;
+// Structure: ResidualMatrix
+// Instance for the matrix-based Edmonds-Karp below: adjacency lists plus
+// a V x V residual capacity matrix. Each caller owns one, so several
+// instances can be solved at the same time. Capacities are 64-bit like
+// the loader's; as in MaxFlowSolver, the flow value must fit in a long long.
+struct ResidualMatrix {
+    int n = 0;
+    int source = -1;
+    int sink = -1;
+    std::vector<std::vector<long long>> capacity;
+    std::vector<std::vector<int>> adj;
 };
 
-int n;
-int source = -1;
-int sink = -1;
-std::vector<std::vector<int>> capacity;
-std::vector<std::vector<int>> adj;
+// Function: buildResidualMatrix
+// Fills the adjacency and capacity matrices of graph from an arc list.
+// Parameters
+// - network, parsed instance
+// - graph, output instance
+//
+// Time Complexity: O(V^2 + E)
+// Space Complexity: O(V^2)
+inline void buildResidualMatrix(const FlowNetwork& network, ResidualMatrix& graph) {
+    graph.source = network.source;
+    graph.sink = network.sink;
 
-using Graph = std::vector<std::vector<Edge>>;
+    // Initialize capacity matrix and adjacency list for Edmonds-Karp
+    graph.n = network.nodes;
+    graph.capacity.assign(graph.n, std::vector<long long>(graph.n, 0));
+    graph.adj.assign(graph.n, std::vector<int>());
+    for (const auto& arc : network.arcs) {
+        int u = arc.from;
+        int v = arc.to;
+        graph.capacity[u][v] += arc.capacity; // In case of multiple edges
+        graph.adj[u].push_back(v);
+        graph.adj[v].push_back(u); // Add reverse edge for residual graph
+    }
+}
 
 // Function: readFile
 // Reads a graph from a file formatted similarly to DIMACS max flow instances.
-// The function initializes global variables for adjacency and capacity matrices.
+// Parsing is delegated to the memory-mapped readFlowNetwork loader.
 // Parameters
 // - filename, path to the input file containing graph data.
+// - graph, output instance
+// Returns:
+//   true if the file was read
 //
 // Time Complexity: O(V^2 + E)
 //   - Reading file lines: O(V + E)
 //   - Constructing adjacency and capacity structures: O(V^2) in worst case
 // Space Complexity: O(V^2)
-void readFile(const std::string& filename) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        std::cerr << "Error: Could not open file " << filename << std::endl;
-        return;
-    }
-
-    std::string line;
-    int nodes = 0;
-    int edges = 0;
-    Graph graph;
-
-    while (std::getline(file, line)) {
-        std::stringstream ss(line);
-        char type;
-        ss >> type;
-
-        if (type == 'c') {
-            //The code reads a comment line, ignores it
-        } else if (type == 'p') {
-            //The code reads a problem line
-            std::string format;
-            ss >> format >> nodes >> edges;
-            graph.resize(nodes);
-
-        } else if (type == 'n'){
-            //The code reads a source or sink node
-            int nodeID;
-            char type;
-            ss >> nodeID >> type;
-            if (type == 's'){
-                //Source line
-                source = nodeID - 1;
-            } else if (type == 't'){
-                //Sink line
-                sink = nodeID - 1;
-            }
-        } else if (type == 'a') {
-            int u;
-            int v; 
-            int capacity;
-            ss >> u >> v >> capacity;
-            graph[u-1].push_back({v - 1, capacity});
-        }
-    }
-    file.close();
-
-    // Initialize capacity matrix and adjacency list for Edmonds-Karp
-    n = nodes;
-    capacity.assign(n, std::vector<int>(n, 0));
-    adj.resize(n);
-    for (int u = 0; u < n; ++u) {
-        for (const auto& edge : graph[u]) {
-            int v = edge.to;
-            capacity[u][v] += edge.capacity; // In case of multiple edges
-            adj[u].push_back(v);
-            adj[v].push_back(u); // Add reverse edge for residual graph
-        }
+inline bool readFile(const std::string& filename, ResidualMatrix& graph) {
+    FlowNetwork network;
+    if (!readFlowNetwork(filename, network)) {
+        return false;
     }
-    
+    buildResidualMatrix(network, graph);
+    return true;
 }
 
 // Function: bfs
 // Performs a BFS to find an augmenting path in the residual graph
 // Returns the flow possible through that path (0 if no path found)
 // Parameters:
+// - graph, residual instance
 // - s, source node
 // - t, sink node
 // - parent, vector to store the parent of each node in the BFS traversal
@@ -104,21 +86,22 @@ void readFile(const std::string& filename) {
 //   Maximum flow that can be pushed through the found augmenting path
 // Time Complexity: O(V + E)
 // Space Complexity: O(V)
-int bfs(int s, int t, std::vector<int>& parent) {
+inline long long bfs(const ResidualMatrix& graph, int s, int t, std::vector<int>& parent) {
+    INSTRUMENT_ADD(FlowBfsCalls, 1);
     std::fill(parent.begin(), parent.end(), -1);
     parent[s] = -2;
-    std::queue<std::pair<int, int>> q;
-    q.push({s, INT_MAX});
+    std::queue<std::pair<int, long long>> q;
+    q.push({s, LLONG_MAX});
 
     while (!q.empty()) {
         int cur = q.front().first;
-        int flow = q.front().second;
+        long long flow = q.front().second;
         q.pop();
 
-        for (int next : adj[cur]) {
-            if (parent[next] == -1 && capacity[cur][next]) {
+        for (int next : graph.adj[cur]) {
+            if (parent[next] == -1 && graph.capacity[cur][next]) {
                 parent[next] = cur;
-                int new_flow = std::min(flow, capacity[cur][next]);
+                long long new_flow = std::min(flow, graph.capacity[cur][next]);
                 if (next == t) {
                     return new_flow;
                 }
@@ -135,30 +118,35 @@ int bfs(int s, int t, std::vector<int>& parent) {
 // Implements the Edmonds-Karp algorithm for finding the maximum flow
 // Uses BFS to find shortest augmenting paths iteratively
 // Parameters:
-// - nodes, total number of nodes in the graph
+// - graph, residual instance; its capacities are consumed by the flow
 // - s, source node
 // - t, sink node
 // Returns:
 //   Maximum flow value from source to sink.
 // Time Complexity: O(V * E^2)
 // Space Complexity: O(V^2)
-int edmondsKarp(int nodes, int s, int t) {
-    int flow = 0;
-    std::vector<int> parent(nodes);
+inline long long edmondsKarp(ResidualMatrix& graph, int s, int t) {
+    long long flow = 0;
+    std::vector<int> parent(graph.n);
 
-    while (bfs(s, t, parent)) {
+    while (bfs(graph, s, t, parent)) {
         
-        int new_flow = INT_MAX;
+        long long new_flow = LLONG_MAX;
+        int length = 0;
         for (int v = t; v != s; v = parent[v]) {
             int u = parent[v];
-            new_flow = std::min(new_flow, capacity[u][v]);
+            new_flow = std::min(new_flow, graph.capacity[u][v]);
+            length++;
         }
+        INSTRUMENT_ADD(FlowAugmentingPaths, 1);
+        INSTRUMENT_ADD(FlowPathArcs, length);
+        INSTRUMENT_MAX(FlowLongestPath, length);
 
        
         for (int v = t; v != s; v = parent[v]) {
             int u = parent[v];
-            capacity[u][v] -= new_flow;
-            capacity[v][u] += new_flow;
+            graph.capacity[u][v] -= new_flow;
+            graph.capacity[v][u] += new_flow;
         }
 
         flow += new_flow;
@@ -166,3 +154,758 @@ int edmondsKarp(int nodes, int s, int t) {
 
     return flow;
 }
+
+// Class: MaxFlowSolver
+// Max flow engine on a compressed sparse row (CSR) residual graph.
+// Every input arc becomes a forward arc in the row of its tail and a
+// paired reverse arc in the row of its head; mate[] links each pair.
+// All per-arc data lives in flat arrays, so memory is O(V + E).
+class MaxFlowSolver {
+public:
+    enum class Algorithm {
+        Dinic,
+        EdmondsKarp,
+        PushRelabel
+    };
+
+    // Returned by addArc() when the arc is rejected
+    static constexpr size_t invalidArc = SIZE_MAX;
+
+    // Constructor: MaxFlowSolver
+    // Builds the CSR residual graph from an arc list
+    // Parameters:
+    // - nodes, number of vertices
+    // - arcs, input arcs with 0-based endpoints
+    // Time Complexity: O(V + E)
+    // Space Complexity: O(V + E)
+    MaxFlowSolver(int nodes, const std::vector<FlowArc>& arcs) : nodes(nodes) {
+        first.assign(nodes + 1, 0);
+        for (const auto& arc : arcs) {
+            ++first[arc.from + 1];
+            ++first[arc.to + 1];
+        }
+        for (int v = 0; v < nodes; ++v) {
+            first[v + 1] += first[v];
+        }
+
+        size_t total = static_cast<size_t>(first[nodes]);
+        head.resize(total);
+        mate.resize(total);
+        residual.resize(total);
+        original.resize(total);
+        arcInput.resize(total);
+        inputArc.resize(arcs.size());
+
+        last.assign(first.begin(), first.end() - 1);
+        for (size_t i = 0; i < arcs.size(); ++i) {
+            int forward = last[arcs[i].from]++;
+            int backward = last[arcs[i].to]++;
+            head[forward] = arcs[i].to;
+            head[backward] = arcs[i].from;
+            mate[forward] = backward;
+            mate[backward] = forward;
+            original[forward] = arcs[i].capacity;
+            original[backward] = 0;
+            arcInput[forward] = static_cast<int>(i);
+            arcInput[backward] = -1;
+            inputArc[i] = forward;
+        }
+        first.pop_back();
+        limit = last;
+        residual = original;
+        level.assign(nodes, -1);
+        current.resize(nodes);
+        queue.resize(nodes);
+    }
+
+    // Function: solve
+    // Computes the maximum flow from s to t on top of the current residual
+    // state (call reset() first to start again from zero flow)
+    // Parameters:
+    // - s, source node
+    // - t, sink node
+    // - algorithm, Dinic (default), EdmondsKarp as a reference mode,
+    //   or the multithreaded PushRelabel
+    // Returns:
+    //   Net change of the s-t flow value made by this call. Pending
+    //   repairs from setCapacity() run first and may lower the value.
+    // Time Complexity: O(V^2 * E) for Dinic and push-relabel,
+    //   O(V * E^2) for Edmonds-Karp
+    // Space Complexity: O(V)
+    long long solve(int s, int t, Algorithm algorithm = Algorithm::Dinic) {
+        if (s < 0 || t < 0 || s >= nodes || t >= nodes || s == t) {
+            return 0;
+        }
+        long long change = repair(s, t);
+        switch (algorithm) {
+            case Algorithm::EdmondsKarp:
+                return change + edmondsKarp(s, t);
+            case Algorithm::PushRelabel:
+                return change + pushRelabel(s, t);
+            default:
+                return change + dinic(s, t);
+        }
+    }
+
+    // Function: flowValue
+    // Net flow currently leaving s
+    // Time Complexity: O(deg(s))
+    long long flowValue(int s) const {
+        long long value = 0;
+        for (int a = first[s]; a < last[s]; ++a) {
+            value += original[a] - residual[a];
+        }
+        return value;
+    }
+
+    // Function: setCapacity
+    // Changes the capacity of input arc i while keeping the current flow.
+    // Increases only add residual capacity. A decrease below the flow on
+    // the arc clips that flow and records the resulting excess at the
+    // tail and deficit at the head; the next solve() repairs them locally
+    // before augmenting, instead of restarting from zero flow.
+    // Parameters:
+    // - i, input arc index (as in the FlowArc list or from addArc)
+    // - capacity, new non-negative capacity
+    // Returns:
+    //   false, leaving the graph unchanged, for an unknown arc or a
+    //   negative capacity
+    // Time Complexity: O(1)
+    bool setCapacity(size_t i, long long capacity) {
+        if (i >= inputArc.size() || capacity < 0) {
+            std::cerr << "Error: Invalid capacity " << capacity << " for arc " << i << std::endl;
+            return false;
+        }
+        int a = inputArc[i];
+        long long flow = original[a] - residual[a];
+        original[a] = capacity;
+        if (flow <= capacity) {
+            residual[a] = capacity - flow;
+            return true;
+        }
+        residual[a] = 0;
+        residual[mate[a]] = capacity;
+        if (head[mate[a]] != head[a]) {
+            pending.push_back({head[mate[a]], head[a], flow - capacity});
+        }
+        return true;
+    }
+
+    // Function: addArc
+    // Appends a new arc with zero flow. A full row is moved to the end of
+    // the arc arrays with twice its size, so insertions are amortized O(1)
+    // and earlier arc indices stay valid.
+    // Parameters:
+    // - from & to, 0-based endpoints
+    // - capacity, non-negative arc capacity
+    // Returns:
+    //   Input arc index of the new arc, or invalidArc (nothing added)
+    //   for an endpoint out of range or a negative capacity
+    // Time Complexity: O(deg) amortized O(1)
+    size_t addArc(int from, int to, long long capacity) {
+        if (from < 0 || to < 0 || from >= nodes || to >= nodes || capacity < 0) {
+            std::cerr << "Error: Invalid arc " << from << " -> " << to << " with capacity " << capacity
+                      << std::endl;
+            return invalidArc;
+        }
+        reserveRow(from, from == to ? 2 : 1);
+        if (from != to) {
+            reserveRow(to, 1);
+        }
+        int forward = last[from]++;
+        int backward = last[to]++;
+        head[forward] = to;
+        head[backward] = from;
+        mate[forward] = backward;
+        mate[backward] = forward;
+        original[forward] = capacity;
+        residual[forward] = capacity;
+        original[backward] = 0;
+        residual[backward] = 0;
+        arcInput[forward] = static_cast<int>(inputArc.size());
+        arcInput[backward] = -1;
+        inputArc.push_back(forward);
+        return inputArc.size() - 1;
+    }
+
+    // Function: setThreads
+    // Sets the worker count used by PushRelabel (0 = hardware threads)
+    void setThreads(unsigned count) {
+        threads = count;
+    }
+
+    // Function: reset
+    // Restores every residual capacity to its original value (zero flow)
+    // Time Complexity: O(E)
+    void reset() {
+        residual = original;
+        pending.clear();
+    }
+
+    // Function: flowOn
+    // Returns the flow currently routed through input arc i
+    long long flowOn(size_t i) const {
+        int a = inputArc[i];
+        return original[a] - residual[a];
+    }
+
+    long long capacityOf(size_t i) const { return original[inputArc[i]]; }
+
+    // Function: sourceSide
+    // Marks the vertices reachable from s in the residual graph; after a
+    // maximum flow from s this is the source side of a minimum cut
+    // Parameters:
+    // - s, source node
+    // - side, output flags of size V (1 = source side)
+    // Time Complexity: O(V + E)
+    void sourceSide(int s, std::vector<char>& side) {
+        clearLevels();
+        side.assign(nodes, 0);
+        int qHead = 0;
+        int qTail = 0;
+        side[s] = 1;
+        queue[qTail++] = s;
+        while (qHead < qTail) {
+            int u = queue[qHead++];
+            for (int a = first[u]; a < last[u]; ++a) {
+                int v = head[a];
+                if (residual[a] > 0 && !side[v]) {
+                    side[v] = 1;
+                    queue[qTail++] = v;
+                }
+            }
+        }
+    }
+
+    int nodeCount() const { return nodes; }
+    size_t arcCount() const { return inputArc.size(); }
+
+private:
+    // Structure: Imbalance
+    // Excess left at tail and deficit at head after a capacity decrease
+    struct Imbalance {
+        int tail;
+        int head;
+        long long amount;
+    };
+
+    int nodes;
+    std::vector<int> first;             // CSR row start per node
+    std::vector<int> last;              // CSR row end per node
+    std::vector<int> limit;             // end of the slots reserved for the row
+    std::vector<int> head;              // arc target
+    std::vector<int> mate;              // index of the paired arc
+    std::vector<long long> residual;    // residual capacity
+    std::vector<long long> original;    // capacity before any flow
+    std::vector<int> arcInput;          // forward CSR arc -> input arc, -1 if reverse
+    std::vector<int> inputArc;          // input arc -> forward CSR arc
+    std::vector<int> level;             // -1 outside the last BFS region
+    std::vector<int> current;           // current-arc pointer per node
+    std::vector<int> queue;
+    int labeled = 0;                    // vertices in queue[] holding a level
+    std::vector<Imbalance> pending;
+    unsigned threads = 0;
+
+    // Function: reserveRow
+    // Makes room for extra arcs in the row of v, moving the row to the
+    // end of the arc arrays and fixing mates and input indices if full
+    // Time Complexity: O(deg(v))
+    void reserveRow(int v, int extra) {
+        if (last[v] + extra <= limit[v]) {
+            return;
+        }
+        int oldFirst = first[v];
+        int oldLast = last[v];
+        int size = oldLast - oldFirst;
+        int base = static_cast<int>(head.size());
+        size_t grown = static_cast<size_t>(base) + std::max(4, 2 * (size + extra));
+        head.resize(grown);
+        mate.resize(grown);
+        residual.resize(grown);
+        original.resize(grown);
+        arcInput.resize(grown);
+
+        for (int i = 0; i < size; ++i) {
+            int a = oldFirst + i;
+            int b = base + i;
+            head[b] = head[a];
+            residual[b] = residual[a];
+            original[b] = original[a];
+            arcInput[b] = arcInput[a];
+            int m = mate[a];
+            if (m >= oldFirst && m < oldLast) {
+                mate[b] = base + (m - oldFirst);
+            } else {
+                mate[b] = m;
+                mate[m] = b;
+            }
+            if (arcInput[b] >= 0) {
+                inputArc[arcInput[b]] = b;
+            }
+        }
+        first[v] = base;
+        last[v] = base + size;
+        limit[v] = static_cast<int>(grown);
+    }
+
+    // Function: clearLevels
+    // Resets only the vertices labeled by the previous BFS
+    void clearLevels() {
+        for (int i = 0; i < labeled; ++i) {
+            level[queue[i]] = -1;
+        }
+        labeled = 0;
+    }
+
+    // Function: buildLevels
+    // BFS from s over arcs with residual capacity, filling level[].
+    // Stops as soon as t is labeled: every vertex closer to s already has
+    // its level, so the search only covers the region the phase needs.
+    // Returns:
+    //   true if t is reachable
+    // Time Complexity: O(V + E)
+    bool buildLevels(int s, int t) {
+        INSTRUMENT_ADD(FlowBfsCalls, 1);
+        clearLevels();
+        int qHead = 0;
+        level[s] = 0;
+        current[s] = first[s];
+        queue[labeled++] = s;
+        while (qHead < labeled) {
+            int u = queue[qHead++];
+            for (int a = first[u]; a < last[u]; ++a) {
+                int v = head[a];
+                if (residual[a] > 0 && level[v] < 0) {
+                    level[v] = level[u] + 1;
+                    current[v] = first[v];
+                    queue[labeled++] = v;
+                    if (v == t) {
+                        return true;
+                    }
+                }
+            }
+        }
+        return false;
+    }
+
+    // Function: repair
+    // Restores conservation after clipped arcs. Each excess is first
+    // rerouted from tail to head; whatever cannot be rerouted is sent
+    // back from tail to s and pulled from t to head, cancelling flow on
+    // the paths that used the arc.
+    // Returns:
+    //   Change of the s-t flow value (zero or negative)
+    // Time Complexity: proportional to the residual region searched
+    long long repair(int s, int t) {
+        long long change = 0;
+        for (const auto& imbalance : pending) {
+            long long rest = imbalance.amount - dinic(imbalance.tail, imbalance.head, imbalance.amount);
+            if (rest == 0) {
+                continue;
+            }
+            if (imbalance.tail != s && imbalance.tail != t) {
+                dinic(imbalance.tail, s, rest);
+            }
+            if (imbalance.head != s && imbalance.head != t) {
+                dinic(t, imbalance.head, rest);
+            }
+            change -= rest;
+        }
+        pending.clear();
+        return change;
+    }
+
+    // Function: dinic
+    // Repeats level-graph BFS followed by an iterative blocking-flow DFS
+    // that keeps a current-arc pointer per node, so no arc is rescanned
+    // within the same phase
+    // Parameters:
+    // - s & t, terminals
+    // - cap, stop once this much flow has been sent
+    // Time Complexity: O(V^2 * E)
+    // Space Complexity: O(V)
+    long long dinic(int s, int t, long long cap = LLONG_MAX) {
+        long long flow = 0;
+        std::vector<int> path;
+        path.reserve(nodes);
+
+        while (flow < cap && buildLevels(s, t)) {
+            path.clear();
+            int v = s;
+
+            while (flow < cap) {
+                if (v == t) {
+                    long long pushed = cap - flow;
+                    for (int a : path) {
+                        pushed = std::min(pushed, residual[a]);
+                    }
+                    size_t cut = path.size();
+                    for (size_t i = 0; i < path.size(); ++i) {
+                        int a = path[i];
+                        residual[a] -= pushed;
+                        residual[mate[a]] += pushed;
+                        if (residual[a] == 0 && cut == path.size()) {
+                            cut = i;
+                        }
+                    }
+                    flow += pushed;
+                    INSTRUMENT_ADD(FlowAugmentingPaths, 1);
+                    INSTRUMENT_ADD(FlowPathArcs, path.size());
+                    INSTRUMENT_MAX(FlowLongestPath, path.size());
+                    // Retreat to the tail of the first saturated arc
+                    path.resize(cut);
+                    v = path.empty() ? s : head[path.back()];
+                    continue;
+                }
+
+                int& a = current[v];
+                while (a < last[v] &&
+                       (residual[a] == 0 || level[head[a]] != level[v] + 1)) {
+                    ++a;
+                }
+
+                if (a < last[v]) {
+                    path.push_back(a);
+                    v = head[a];
+                } else {
+                    // Dead end: drop v from the level graph and back up
+                    level[v] = -1;
+                    if (path.empty()) {
+                        break;
+                    }
+                    path.pop_back();
+                    v = path.empty() ? s : head[path.back()];
+                }
+            }
+        }
+        return flow;
+    }
+
+    // Function: edmondsKarp
+    // Reference mode: shortest augmenting paths on the CSR graph
+    // Time Complexity: O(V * E^2)
+    // Space Complexity: O(V)
+    long long edmondsKarp(int s, int t) {
+        long long flow = 0;
+        std::vector<int> parentArc(nodes);
+        clearLevels();
+
+        while (true) {
+            INSTRUMENT_ADD(FlowBfsCalls, 1);
+            std::fill(parentArc.begin(), parentArc.end(), -1);
+            int qHead = 0;
+            int qTail = 0;
+            queue[qTail++] = s;
+            bool found = false;
+            while (qHead < qTail && !found) {
+                int u = queue[qHead++];
+                for (int a = first[u]; a < last[u]; ++a) {
+                    int v = head[a];
+                    if (residual[a] > 0 && v != s && parentArc[v] == -1) {
+                        parentArc[v] = a;
+                        if (v == t) {
+                            found = true;
+                            break;
+                        }
+                        queue[qTail++] = v;
+                    }
+                }
+            }
+            if (!found) {
+                break;
+            }
+
+            long long pushed = LLONG_MAX;
+            size_t length = 0;
+            for (int v = t; v != s; v = head[mate[parentArc[v]]]) {
+                pushed = std::min(pushed, residual[parentArc[v]]);
+                length++;
+            }
+            INSTRUMENT_ADD(FlowAugmentingPaths, 1);
+            INSTRUMENT_ADD(FlowPathArcs, length);
+            INSTRUMENT_MAX(FlowLongestPath, length);
+            for (int v = t; v != s; v = head[mate[parentArc[v]]]) {
+                residual[parentArc[v]] -= pushed;
+                residual[mate[parentArc[v]]] += pushed;
+            }
+            flow += pushed;
+        }
+        return flow;
+    }
+
+    // Structure: PushRelabelState
+    // Per-solve arrays of the parallel push-relabel. Excess is owned by
+    // the vertex being discharged; pushes from other threads land in
+    // incoming[] through atomic adds and are merged between rounds.
+    struct PushRelabelState {
+        std::vector<std::atomic<int>> label;
+        std::vector<int> nextLabel;
+        std::vector<long long> excess;
+        std::vector<std::atomic<long long>> incoming;
+        std::vector<std::atomic<char>> queued;
+        std::vector<std::atomic<int>> count;        // vertices per label, phase 1 only
+        std::vector<std::vector<int>> local;        // per-worker scratch list
+        std::vector<int> active;
+        std::vector<int> touched;
+
+        PushRelabelState(int nodes, unsigned workers)
+            : label(nodes), nextLabel(nodes, 0), excess(nodes, 0), incoming(nodes),
+              queued(nodes), count(nodes + 1), local(workers) {
+            for (int v = 0; v < nodes; ++v) {
+                incoming[v].store(0, std::memory_order_relaxed);
+                queued[v].store(0, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    // Function: gatherLocal
+    // Concatenates and clears the per-worker lists into out
+    static void gatherLocal(PushRelabelState& st, std::vector<int>& out) {
+        out.clear();
+        for (auto& list : st.local) {
+            out.insert(out.end(), list.begin(), list.end());
+            list.clear();
+        }
+    }
+
+    // Function: globalRelabel
+    // Sets every label to the exact residual distance to goal with a
+    // level-synchronous reverse BFS; frontier vertices are expanded in
+    // parallel and claimed with a CAS on their label. Vertices that cannot
+    // reach goal (and the blocked terminal) get label cap.
+    // Time Complexity: O(V + E)
+    void globalRelabel(ThreadPool& pool, PushRelabelState& st, int goal, int blocked, int cap, bool counting) {
+        pool.parallelFor(nodes, 4096, [&](unsigned, size_t b, size_t e) {
+            for (size_t v = b; v < e; ++v) {
+                st.label[v].store(cap, std::memory_order_relaxed);
+            }
+        });
+        st.label[goal].store(0, std::memory_order_relaxed);
+        std::vector<int> frontier(1, goal);
+        std::vector<int> next;
+        int depth = 0;
+
+        while (!frontier.empty()) {
+            ++depth;
+            pool.parallelFor(frontier.size(), 256, [&](unsigned worker, size_t b, size_t e) {
+                for (size_t i = b; i < e; ++i) {
+                    int w = frontier[i];
+                    for (int a = first[w]; a < last[w]; ++a) {
+                        int u = head[a];
+                        if (u == blocked || residual[mate[a]] <= 0) {
+                            continue;
+                        }
+                        int expected = cap;
+                        if (st.label[u].compare_exchange_strong(expected, depth, std::memory_order_relaxed)) {
+                            st.local[worker].push_back(u);
+                        }
+                    }
+                }
+            });
+            gatherLocal(st, next);
+            frontier.swap(next);
+        }
+
+        if (counting) {
+            for (auto& c : st.count) {
+                c.store(0, std::memory_order_relaxed);
+            }
+            pool.parallelFor(nodes, 4096, [&](unsigned, size_t b, size_t e) {
+                for (size_t v = b; v < e; ++v) {
+                    int d = st.label[v].load(std::memory_order_relaxed);
+                    if (d < cap) {
+                        st.count[d].fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+            });
+        }
+    }
+
+    // Function: dropInactive
+    // Removes vertices at label cap from the active list
+    static void dropInactive(PushRelabelState& st, int cap) {
+        size_t kept = 0;
+        for (int v : st.active) {
+            if (st.label[v].load(std::memory_order_relaxed) < cap) {
+                st.active[kept++] = v;
+            } else {
+                st.queued[v].store(0, std::memory_order_relaxed);
+            }
+        }
+        st.active.resize(kept);
+    }
+
+    // Function: pushRelabelPhase
+    // Synchronous FIFO rounds until no vertex below cap holds excess.
+    // Each round: (A) every active vertex pushes along arcs that are
+    // admissible under the labels of the round start; admissibility is
+    // antisymmetric, so no two threads ever touch the same arc pair.
+    // (B) vertices with excess left compute a new label. (C) labels and
+    // incoming excess are applied and the next active set is built.
+    // The gap heuristic runs after (C) when counting is enabled, and a
+    // global relabel is triggered after O(V + E) relabel work.
+    // Time Complexity: O(V^2 * E) worst case
+    void pushRelabelPhase(ThreadPool& pool, PushRelabelState& st, int goal, int blocked, int cap, bool counting) {
+        const size_t relabelThreshold = 6 * static_cast<size_t>(nodes) + head.size();
+        std::atomic<size_t> work(relabelThreshold);  // forces an initial global relabel
+        const size_t grain = 64;
+
+        while (true) {
+            if (work.load(std::memory_order_relaxed) >= relabelThreshold) {
+                globalRelabel(pool, st, goal, blocked, cap, counting);
+                work.store(0, std::memory_order_relaxed);
+                dropInactive(st, cap);
+            }
+            if (st.active.empty()) {
+                break;
+            }
+
+            // (A) push
+            pool.parallelFor(st.active.size(), grain, [&](unsigned worker, size_t b, size_t e) {
+                for (size_t i = b; i < e; ++i) {
+                    int v = st.active[i];
+                    int d = st.label[v].load(std::memory_order_relaxed);
+                    long long ex = st.excess[v];
+                    for (int a = first[v]; a < last[v] && ex > 0; ++a) {
+                        int u = head[a];
+                        if (st.label[u].load(std::memory_order_relaxed) + 1 != d || residual[a] <= 0) {
+                            continue;
+                        }
+                        long long delta = std::min(ex, residual[a]);
+                        residual[a] -= delta;
+                        residual[mate[a]] += delta;
+                        ex -= delta;
+                        st.incoming[u].fetch_add(delta, std::memory_order_relaxed);
+                        if (u != goal && u != blocked && st.queued[u].exchange(1) == 0) {
+                            st.local[worker].push_back(u);
+                        }
+                    }
+                    st.excess[v] = ex;
+                }
+            });
+            gatherLocal(st, st.touched);
+
+            // (B) relabel
+            pool.parallelFor(st.active.size(), grain, [&](unsigned, size_t b, size_t e) {
+                size_t scanned = 0;
+                for (size_t i = b; i < e; ++i) {
+                    int v = st.active[i];
+                    int d = st.label[v].load(std::memory_order_relaxed);
+                    if (st.excess[v] == 0) {
+                        st.nextLabel[v] = d;
+                        continue;
+                    }
+                    int lowest = cap;
+                    for (int a = first[v]; a < last[v]; ++a) {
+                        if (residual[a] > 0) {
+                            lowest = std::min(lowest, st.label[head[a]].load(std::memory_order_relaxed) + 1);
+                        }
+                    }
+                    st.nextLabel[v] = std::max(d, std::min(lowest, cap));
+                    scanned += static_cast<size_t>(last[v] - first[v]) + 12;
+                }
+                work.fetch_add(scanned, std::memory_order_relaxed);
+            });
+
+            // (C) apply labels, merge excess, build the next active set
+            std::atomic<int> gap(cap);
+            pool.parallelFor(st.active.size(), grain, [&](unsigned worker, size_t b, size_t e) {
+                for (size_t i = b; i < e; ++i) {
+                    int v = st.active[i];
+                    int oldLabel = st.label[v].load(std::memory_order_relaxed);
+                    int newLabel = st.nextLabel[v];
+                    if (newLabel != oldLabel) {
+                        st.label[v].store(newLabel, std::memory_order_relaxed);
+                        if (counting) {
+                            if (newLabel < cap) {
+                                st.count[newLabel].fetch_add(1, std::memory_order_relaxed);
+                            }
+                            if (st.count[oldLabel].fetch_sub(1, std::memory_order_relaxed) == 1) {
+                                int seen = gap.load(std::memory_order_relaxed);
+                                while (oldLabel < seen && !gap.compare_exchange_weak(seen, oldLabel)) {
+                                }
+                            }
+                        }
+                    }
+                    st.excess[v] += st.incoming[v].exchange(0, std::memory_order_relaxed);
+                    if (st.excess[v] > 0 && newLabel < cap) {
+                        st.local[worker].push_back(v);
+                    } else {
+                        st.queued[v].store(0, std::memory_order_relaxed);
+                    }
+                }
+            });
+            pool.parallelFor(st.touched.size(), grain, [&](unsigned worker, size_t b, size_t e) {
+                for (size_t i = b; i < e; ++i) {
+                    int v = st.touched[i];
+                    st.excess[v] += st.incoming[v].exchange(0, std::memory_order_relaxed);
+                    if (st.excess[v] > 0 && st.label[v].load(std::memory_order_relaxed) < cap) {
+                        st.local[worker].push_back(v);
+                    } else {
+                        st.queued[v].store(0, std::memory_order_relaxed);
+                    }
+                }
+            });
+            gatherLocal(st, st.active);
+
+            // Gap heuristic: nothing at label g means nothing above it can reach goal
+            int g = gap.load(std::memory_order_relaxed);
+            if (counting && g < cap && st.count[g].load(std::memory_order_relaxed) == 0) {
+                pool.parallelFor(nodes, 4096, [&](unsigned, size_t b, size_t e) {
+                    for (size_t v = b; v < e; ++v) {
+                        int d = st.label[v].load(std::memory_order_relaxed);
+                        if (d > g && d < cap) {
+                            st.label[v].store(cap, std::memory_order_relaxed);
+                            st.count[d].fetch_sub(1, std::memory_order_relaxed);
+                        }
+                    }
+                });
+                dropInactive(st, cap);
+            }
+        }
+    }
+
+    // Function: pushRelabel
+    // Parallel push-relabel in two phases. Phase 1 saturates the arcs
+    // leaving s and discharges vertices below label V toward t, giving a
+    // maximum preflow (the flow value). Phase 2 runs the same rounds with
+    // s as the goal to return leftover excess, so the residual graph
+    // afterwards holds a valid flow like the other modes.
+    // Time Complexity: O(V^2 * E) worst case, O(V + E) per round
+    // Space Complexity: O(V)
+    long long pushRelabel(int s, int t) {
+        ThreadPool pool(threads);
+        PushRelabelState st(nodes, pool.size());
+
+        for (int a = first[s]; a < last[s]; ++a) {
+            long long delta = residual[a];
+            if (delta > 0 && head[a] != s) {
+                residual[a] = 0;
+                residual[mate[a]] += delta;
+                st.excess[head[a]] += delta;
+            }
+        }
+        for (int v = 0; v < nodes; ++v) {
+            if (v != s && v != t && st.excess[v] > 0) {
+                st.active.push_back(v);
+                st.queued[v].store(1, std::memory_order_relaxed);
+            }
+        }
+
+        pushRelabelPhase(pool, st, t, s, nodes, true);
+        long long flow = st.excess[t] + st.incoming[t].exchange(0);
+
+        // Phase 2: every vertex still holding excess sends it back to s
+        const int unreachable = INT_MAX / 2;
+        for (int v = 0; v < nodes; ++v) {
+            if (v != s && v != t && st.excess[v] > 0) {
+                st.active.push_back(v);
+                st.queued[v].store(1, std::memory_order_relaxed);
+            }
+        }
+        pushRelabelPhase(pool, st, s, t, unreachable, false);
+        return flow;
+    }
+};
+
+#endif
@@ -0,0 +1,184 @@
+/*
+    Gomory-Hu Tree
+    Description:
+    Builds a flow-equivalent (Gomory-Hu) tree of an undirected network
+    with Gusfield's algorithm: V - 1 max flow computations on the
+    original graph, no contractions. After the build, the min cut between
+    any pair u, v is the lightest edge on their tree path, answered in
+    O(log V) with binary lifting.
+
+    Each worker owns one MaxFlowSolver copy that is reset and reused for
+    all of its cuts. Cuts are computed speculatively in windows of one
+    cut per worker and committed in Gusfield order; a cut whose sink was
+    changed by an earlier commit in the same window is recomputed.
+*/
+
+#ifndef GOMORY_HU_HPP
+#define GOMORY_HU_HPP
+
+#include <vector>
+#include <climits>
+#include <algorithm>
+#include "ford_fulkerson.hpp"
+#include "thread_pool.hpp"
+
+class GomoryHuTree {
+public:
+    // Function: build
+    // Computes the tree for an undirected network
+    // Parameters:
+    // - nodes, number of vertices
+    // - edges, undirected edges; capacity is used in both directions
+    // - threads, workers computing cuts in parallel (0 = hardware threads)
+    // Time Complexity: O(V * maxflow) work, O(V log V) for the query tables
+    // Space Complexity: O(threads * (V + E) + V log V)
+    void build(int nodes, const std::vector<FlowArc>& edges, unsigned threads = 0) {
+        count = nodes;
+        parent.assign(nodes, 0);
+        weight.assign(nodes, 0);
+        if (nodes <= 1) {
+            buildLifting();
+            return;
+        }
+
+        std::vector<FlowArc> arcs;
+        arcs.reserve(edges.size() * 2);
+        for (const auto& e : edges) {
+            arcs.push_back(e);
+            arcs.push_back({e.to, e.from, e.capacity});
+        }
+
+        ThreadPool pool(threads);
+        unsigned workers = pool.size();
+        std::vector<MaxFlowSolver> solvers(workers, MaxFlowSolver(nodes, arcs));
+        std::vector<std::vector<char>> sides(workers);
+        std::vector<long long> values(workers);
+        std::vector<int> sinks(workers);
+
+        int next = 1;
+        while (next < nodes) {
+            int window = std::min<int>(static_cast<int>(workers), nodes - next);
+            pool.run([&](unsigned worker) {
+                if (static_cast<int>(worker) >= window) {
+                    return;
+                }
+                int s = next + static_cast<int>(worker);
+                sinks[worker] = parent[s];
+                MaxFlowSolver& solver = solvers[worker];
+                solver.reset();
+                values[worker] = solver.solve(s, sinks[worker]);
+                solver.sourceSide(s, sides[worker]);
+            });
+
+            // Commit in order; stop at the first cut whose sink went stale
+            int committed = 0;
+            while (committed < window) {
+                int s = next + committed;
+                if (parent[s] != sinks[committed]) {
+                    break;
+                }
+                weight[s] = values[committed];
+                const std::vector<char>& side = sides[committed];
+                int t = parent[s];
+                for (int i = s + 1; i < nodes; ++i) {
+                    if (side[i] && parent[i] == t) {
+                        parent[i] = s;
+                    }
+                }
+                ++committed;
+            }
+            next += committed;
+        }
+        buildLifting();
+    }
+
+    // Function: minCut
+    // Minimum cut value between u and v
+    // Time Complexity: O(log V)
+    long long minCut(int u, int v) const {
+        if (u == v) {
+            return LLONG_MAX;
+        }
+        long long best = LLONG_MAX;
+        if (depth[u] < depth[v]) {
+            std::swap(u, v);
+        }
+        int diff = depth[u] - depth[v];
+        for (int k = 0; diff > 0; ++k, diff >>= 1) {
+            if (diff & 1) {
+                best = std::min(best, lightest[k][u]);
+                u = up[k][u];
+            }
+        }
+        if (u == v) {
+            return best;
+        }
+        for (int k = static_cast<int>(up.size()) - 1; k >= 0; --k) {
+            if (up[k][u] != up[k][v]) {
+                best = std::min(best, std::min(lightest[k][u], lightest[k][v]));
+                u = up[k][u];
+                v = up[k][v];
+            }
+        }
+        return std::min(best, std::min(lightest[0][u], lightest[0][v]));
+    }
+
+    // Tree edge (v, parent(v)) with weight(v) for every v != 0
+    int parentOf(int v) const { return parent[v]; }
+    long long weightOf(int v) const { return weight[v]; }
+    int nodeCount() const { return count; }
+
+private:
+    int count = 0;
+    std::vector<int> parent;
+    std::vector<long long> weight;
+    std::vector<int> depth;
+    std::vector<std::vector<int>> up;
+    std::vector<std::vector<long long>> lightest;
+
+    // Function: buildLifting
+    // Fills depth and the 2^k ancestor / path-minimum tables
+    // Time Complexity: O(V log V)
+    void buildLifting() {
+        depth.assign(count, 0);
+        // Gusfield parents are not ordered by index, so compute depths by
+        // walking each chain once and memoizing
+        std::vector<char> done(count, 0);
+        std::vector<int> chain;
+        if (count > 0) {
+            done[0] = 1;
+        }
+        for (int v = 1; v < count; ++v) {
+            int u = v;
+            chain.clear();
+            while (!done[u]) {
+                chain.push_back(u);
+                u = parent[u];
+            }
+            for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+                depth[*it] = depth[parent[*it]] + 1;
+                done[*it] = 1;
+            }
+        }
+
+        int levels = 1;
+        while ((1 << levels) < count) {
+            ++levels;
+        }
+        up.assign(levels, std::vector<int>(count, 0));
+        lightest.assign(levels, std::vector<long long>(count, LLONG_MAX));
+        for (int v = 0; v < count; ++v) {
+            up[0][v] = parent[v];
+            lightest[0][v] = v == 0 ? LLONG_MAX : weight[v];
+        }
+        for (int k = 1; k < levels; ++k) {
+            for (int v = 0; v < count; ++v) {
+                int mid = up[k - 1][v];
+                up[k][v] = up[k - 1][mid];
+                lightest[k][v] = std::min(lightest[k - 1][v], lightest[k - 1][mid]);
+            }
+        }
+    }
+};
+
+#endif
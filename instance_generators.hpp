@@ -0,0 +1,217 @@
+/*
+    Instance generators
+    Description:
+    Seeded synthetic inputs for the benchmarks: random geometric graphs
+    and dense matrices for MST and TSP, grid and layered networks for
+    max flow, and uniform or clustered point sets for Voronoi. The same
+    seed and size always give the same instance (std::mt19937_64 with
+    hand-rolled distributions, so results do not depend on the standard
+    library).
+*/
+
+#ifndef INSTANCE_GENERATORS_HPP
+#define INSTANCE_GENERATORS_HPP
+
+#include <vector>
+#include <random>
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+#include "kruskal.hpp"          // FlatEdge
+#include "distance_matrix.hpp"
+#include "dimacs_loader.hpp"    // FlowNetwork
+#include "voronoi_sites.hpp"    // SitePoint
+using namespace std;
+
+// Uniform double in [0, 1)
+inline double unitRandom(mt19937_64 &rng) {
+    return (rng() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// Uniform integer in [low, high]
+inline long long rangeRandom(mt19937_64 &rng, long long low, long long high) {
+    return low + (long long)(rng() % (uint64_t)(high - low + 1));
+}
+
+/*
+    Function: randomPoints
+    Description:
+    n points uniform in the square [0, side)^2.
+*/
+inline vector<SitePoint> randomPoints(size_t n, uint64_t seed, double side = 1.0) {
+    mt19937_64 rng(seed);
+    vector<SitePoint> points(n);
+    for (auto &p : points) {
+        p.x = unitRandom(rng) * side;
+        p.y = unitRandom(rng) * side;
+    }
+    return points;
+}
+
+/*
+    Function: clusteredPoints
+    Description:
+    n points in Gaussian clusters (Box-Muller) around uniform centers in
+    the square [0, side)^2; the spread is side / (4 * sqrt(clusters)).
+*/
+inline vector<SitePoint> clusteredPoints(size_t n, int clusters, uint64_t seed, double side = 1.0) {
+    mt19937_64 rng(seed);
+    clusters = max(clusters, 1);
+    vector<SitePoint> centers(clusters);
+    for (auto &c : centers) {
+        c.x = unitRandom(rng) * side;
+        c.y = unitRandom(rng) * side;
+    }
+    double spread = side / (4 * sqrt((double)clusters));
+    vector<SitePoint> points(n);
+    for (auto &p : points) {
+        const SitePoint &c = centers[rng() % clusters];
+        double radius = spread * sqrt(-2 * log(1 - unitRandom(rng)));
+        double angle = 6.283185307179586 * unitRandom(rng);
+        p.x = c.x + radius * cos(angle);
+        p.y = c.y + radius * sin(angle);
+    }
+    return points;
+}
+
+/*
+    Function: geometricGraph
+    Description:
+    Random geometric graph: V uniform points in the unit square joined
+    when closer than the radius that gives the requested average degree.
+    Weights are the distances scaled to 1..1000. Neighbors are found
+    through a grid of radius-sized buckets.
+
+    Return value:
+    The edges, each pair once with u < v
+*/
+inline vector<FlatEdge> geometricGraph(int V, double degree, uint64_t seed) {
+    vector<SitePoint> points = randomPoints(V, seed);
+    double radius = sqrt(degree / (3.141592653589793 * max(V, 1)));
+    int cells = max(1, min((int)(1 / radius), 4096));
+    vector<vector<int>> bucket((size_t)cells * cells);
+    auto cellOf = [&](double c) { return min((int)(c * cells), cells - 1); };
+    for (int i = 0; i < V; i++) {
+        bucket[(size_t)cellOf(points[i].y) * cells + cellOf(points[i].x)].push_back(i);
+    }
+
+    vector<FlatEdge> edges;
+    edges.reserve((size_t)(V * degree / 2 * 1.1));
+    for (int i = 0; i < V; i++) {
+        int cx = cellOf(points[i].x), cy = cellOf(points[i].y);
+        for (int y = max(cy - 1, 0); y <= min(cy + 1, cells - 1); y++) {
+            for (int x = max(cx - 1, 0); x <= min(cx + 1, cells - 1); x++) {
+                for (int j : bucket[(size_t)y * cells + x]) {
+                    if (j <= i) {
+                        continue;
+                    }
+                    double d = hypot(points[i].x - points[j].x, points[i].y - points[j].y);
+                    if (d < radius) {
+                        edges.push_back({(uint32_t)i, (uint32_t)j, (int32_t)(d / radius * 999) + 1});
+                    }
+                }
+            }
+        }
+    }
+    return edges;
+}
+
+/*
+    Function: denseMatrix
+    Description:
+    Symmetric V x V row-major matrix of uniform weights in 1..maxWeight
+    with a zero diagonal (the graph.txt layout).
+*/
+inline vector<int> denseMatrix(int V, uint64_t seed, int maxWeight = 1000) {
+    mt19937_64 rng(seed);
+    vector<int> matrix((size_t)V * V, 0);
+    for (int i = 0; i < V; i++) {
+        for (int j = i + 1; j < V; j++) {
+            int w = (int)rangeRandom(rng, 1, maxWeight);
+            matrix[(size_t)i * V + j] = w;
+            matrix[(size_t)j * V + i] = w;
+        }
+    }
+    return matrix;
+}
+
+/*
+    Function: euclideanMatrix
+    Description:
+    Distance matrix of n uniform cities in a square of the given side,
+    rounded to integers (at least 1), as a TSP instance.
+*/
+template <class T>
+DistanceMatrix<T> euclideanMatrix(int n, uint64_t seed, double side = 10000.0) {
+    vector<SitePoint> cities = randomPoints(n, seed, side);
+    DistanceMatrix<T> graph(n);
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            double d = hypot(cities[i].x - cities[j].x, cities[i].y - cities[j].y);
+            graph.set(i, j, (T)max(1.0, round(d)));
+        }
+    }
+    return graph;
+}
+
+/*
+    Function: gridFlowNetwork
+    Description:
+    rows x cols grid with arcs both ways between 4-neighbors, plus a
+    source feeding the left column and a sink draining the right one
+    (capacity rows * maxCapacity each). Capacities are in 1..maxCapacity.
+*/
+inline FlowNetwork gridFlowNetwork(int rows, int cols, uint64_t seed, long long maxCapacity = 100) {
+    mt19937_64 rng(seed);
+    FlowNetwork network;
+    network.nodes = rows * cols + 2;
+    network.source = rows * cols;
+    network.sink = rows * cols + 1;
+    auto id = [&](int r, int c) { return r * cols + c; };
+    for (int r = 0; r < rows; r++) {
+        for (int c = 0; c < cols; c++) {
+            if (c + 1 < cols) {
+                network.arcs.push_back({id(r, c), id(r, c + 1), rangeRandom(rng, 1, maxCapacity)});
+                network.arcs.push_back({id(r, c + 1), id(r, c), rangeRandom(rng, 1, maxCapacity)});
+            }
+            if (r + 1 < rows) {
+                network.arcs.push_back({id(r, c), id(r + 1, c), rangeRandom(rng, 1, maxCapacity)});
+                network.arcs.push_back({id(r + 1, c), id(r, c), rangeRandom(rng, 1, maxCapacity)});
+            }
+        }
+        network.arcs.push_back({network.source, id(r, 0), rows * maxCapacity});
+        network.arcs.push_back({id(r, cols - 1), network.sink, rows * maxCapacity});
+    }
+    return network;
+}
+
+/*
+    Function: layeredFlowNetwork
+    Description:
+    layers x width nodes; every node sends degree arcs to random nodes
+    of the next layer. The source feeds the first layer and the last
+    layer drains into the sink. Capacities are in 1..maxCapacity.
+*/
+inline FlowNetwork layeredFlowNetwork(int layers, int width, int degree, uint64_t seed,
+                                      long long maxCapacity = 100) {
+    mt19937_64 rng(seed);
+    FlowNetwork network;
+    network.nodes = layers * width + 2;
+    network.source = layers * width;
+    network.sink = layers * width + 1;
+    for (int v = 0; v < width; v++) {
+        network.arcs.push_back({network.source, v, degree * maxCapacity});
+        network.arcs.push_back({(layers - 1) * width + v, network.sink, degree * maxCapacity});
+    }
+    for (int l = 0; l + 1 < layers; l++) {
+        for (int v = 0; v < width; v++) {
+            for (int k = 0; k < degree; k++) {
+                int to = (l + 1) * width + (int)(rng() % width);
+                network.arcs.push_back({l * width + v, to, rangeRandom(rng, 1, maxCapacity)});
+            }
+        }
+    }
+    return network;
+}
+
+#endif
@@ -0,0 +1,290 @@
+/*
+    Instrumentation
+    Description:
+    Hot-path counters and phase timers, compiled in only when
+    GRAPH_INSTRUMENTATION is defined (CMake option of the same name).
+    Without it every INSTRUMENT_* macro expands to nothing and the
+    solvers are unchanged.
+
+    Each thread counts into its own CounterBlock, reached through a
+    plain thread_local pointer, so parallel solvers never write to a
+    shared counter. Blocks are registered on a thread's first count.
+    When the thread exits its block is merged into the registry's
+    retired total and freed, so short-lived pools (one per solve) do not
+    grow the registry. writeMetricsReport() sums the live blocks and the
+    retired total, so it must only be called while no instrumented work
+    is running (after the thread pools have been joined).
+
+    Phases are timed with a PhaseClock: lap(phase) charges the time
+    since the previous lap to that phase, which suits straight-line
+    parse / build / solve / output code.
+*/
+
+#ifndef INSTRUMENTATION_HPP
+#define INSTRUMENTATION_HPP
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <chrono>
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace instrumentation {
+
+enum class Counter {
+    FlowBfsCalls,           // BFS passes (Edmonds-Karp searches, Dinic level graphs)
+    FlowAugmentingPaths,
+    FlowPathArcs,           // total arcs over all augmenting paths
+    FlowLongestPath,        // maximum
+    MstEdgesScanned,        // edges (Kruskal) or matrix entries (Prim) examined
+    MstFindCalls,
+    MstFindSteps,           // parent links followed by find
+    MstDeepestFind,         // maximum
+    TspTours,               // nearest-neighbor tours started
+    TspToursPruned,         // abandoned against the best known tour
+    TspCandidateScans,      // argminMasked calls
+    TspCandidatesScanned,   // row entries those calls examined
+    Count
+};
+
+enum class Phase {
+    Parse,
+    Build,
+    Solve,
+    Output,
+    Count
+};
+
+static const char *const counterNames[] = {
+    "flow.bfs_calls",       "flow.augmenting_paths", "flow.path_arcs",          "flow.longest_path",
+    "mst.edges_scanned",    "mst.find_calls",        "mst.find_steps",          "mst.deepest_find",
+    "tsp.tours",            "tsp.tours_pruned",      "tsp.candidate_scans",     "tsp.candidates_scanned",
+};
+
+static const char *const phaseNames[] = {"parse", "build", "solve", "output"};
+
+inline bool isMaximum(Counter counter) {
+    return counter == Counter::FlowLongestPath || counter == Counter::MstDeepestFind;
+}
+
+// Structure: CounterBlock
+// One thread's counters and phase times, on its own cache lines
+struct alignas(64) CounterBlock {
+    uint64_t counters[(int)Counter::Count] = {};
+    double phaseSeconds[(int)Phase::Count] = {};
+
+    void add(Counter counter, uint64_t amount) { counters[(int)counter] += amount; }
+
+    void raise(Counter counter, uint64_t value) {
+        uint64_t &slot = counters[(int)counter];
+        slot = value > slot ? value : slot;
+    }
+
+    void merge(const CounterBlock &other) {
+        for (int c = 0; c < (int)Counter::Count; c++) {
+            if (isMaximum((Counter)c)) raise((Counter)c, other.counters[c]);
+            else counters[c] += other.counters[c];
+        }
+        for (int p = 0; p < (int)Phase::Count; p++) {
+            phaseSeconds[p] += other.phaseSeconds[p];
+        }
+    }
+
+    bool empty() const {
+        for (uint64_t c : counters) {
+            if (c) return false;
+        }
+        for (double s : phaseSeconds) {
+            if (s > 0) return false;
+        }
+        return true;
+    }
+};
+
+struct Registry {
+    std::mutex lock;
+    std::vector<std::unique_ptr<CounterBlock>> blocks;    // live threads
+    CounterBlock retired;                                  // exited threads
+    size_t retiredThreads = 0;                             // exited threads that recorded anything
+};
+
+// Start of the run, taken during static initialization
+inline const std::chrono::steady_clock::time_point processStart = std::chrono::steady_clock::now();
+
+inline Registry &registry() {
+    static Registry instance;
+    return instance;
+}
+
+// Structure: BlockRetirer
+// Merges a thread's block into the retired total when the thread exits
+struct BlockRetirer {
+    CounterBlock *block = nullptr;
+
+    ~BlockRetirer() {
+        Registry &r = registry();
+        std::lock_guard<std::mutex> guard(r.lock);
+        for (size_t i = 0; i < r.blocks.size(); i++) {
+            if (r.blocks[i].get() == block) {
+                if (!block->empty()) {
+                    r.retired.merge(*block);
+                    r.retiredThreads++;
+                }
+                r.blocks.erase(r.blocks.begin() + i);
+                break;
+            }
+        }
+    }
+};
+
+// Function: local
+// The calling thread's block, registered on first use. The hot path
+// only reads the plain pointer; the retirer is set up once per thread.
+inline CounterBlock &local() {
+    static thread_local CounterBlock *block = nullptr;
+    if (block == nullptr) {
+        Registry &r = registry();
+        {
+            std::lock_guard<std::mutex> guard(r.lock);
+            r.blocks.emplace_back(new CounterBlock());
+            block = r.blocks.back().get();
+        }
+        static thread_local BlockRetirer retirer;
+        retirer.block = block;
+    }
+    return *block;
+}
+
+// Class: PhaseClock
+// Charges wall time to phases; see the file comment
+class PhaseClock {
+public:
+    void lap(Phase phase) {
+        auto now = std::chrono::steady_clock::now();
+        local().phaseSeconds[(int)phase] += std::chrono::duration<double>(now - last).count();
+        last = now;
+    }
+
+private:
+    std::chrono::steady_clock::time_point last = std::chrono::steady_clock::now();
+};
+
+// Function: peakMemoryBytes
+// Peak resident set size of the process (0 if unknown)
+inline uint64_t peakMemoryBytes() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS info;
+    if (K32GetProcessMemoryInfo(GetCurrentProcess(), &info, sizeof info)) {
+        return info.PeakWorkingSetSize;
+    }
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#ifdef __APPLE__
+    return (uint64_t)usage.ru_maxrss;           // bytes
+#else
+    return (uint64_t)usage.ru_maxrss * 1024;    // kilobytes
+#endif
+#endif
+}
+
+inline void writeBlock(FILE *out, const CounterBlock &block) {
+    fprintf(out, "{\"phases\":{");
+    for (int p = 0; p < (int)Phase::Count; p++) {
+        fprintf(out, "%s\"%s_s\":%.9g", p ? "," : "", phaseNames[p], block.phaseSeconds[p]);
+    }
+    fprintf(out, "},\"counters\":{");
+    for (int c = 0; c < (int)Counter::Count; c++) {
+        fprintf(out, "%s\"%s\":%llu", c ? "," : "", counterNames[c], (unsigned long long)block.counters[c]);
+    }
+    fprintf(out, "}}");
+}
+
+/*
+    Function: writeMetricsReport
+    Description:
+    Writes the JSON report: whether counters were compiled in, wall time
+    since start-up, peak memory, the totals, one entry per live thread
+    that recorded anything and the merged counts of the threads that
+    have exited.
+
+    Parameters:
+    filename: output file, or "-" for standard error
+
+    Return value:
+    true if the report was written
+*/
+inline bool writeMetricsReport(const std::string &filename) {
+    FILE *out = filename == "-" ? stderr : fopen(filename.c_str(), "w");
+    if (out == nullptr) {
+        return false;
+    }
+    Registry &r = registry();
+    std::lock_guard<std::mutex> guard(r.lock);
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - processStart).count();
+#ifdef GRAPH_INSTRUMENTATION
+    const char *enabled = "true";
+#else
+    const char *enabled = "false";
+#endif
+    fprintf(out, "{\"instrumented\":%s,\"wall_s\":%.9g,\"peak_memory_bytes\":%llu,\"total\":", enabled, wall,
+            (unsigned long long)peakMemoryBytes());
+    CounterBlock total = r.retired;
+    for (const auto &block : r.blocks) {
+        total.merge(*block);
+    }
+    writeBlock(out, total);
+    fprintf(out, ",\"threads\":[");
+    bool firstThread = true;
+    for (size_t t = 0; t < r.blocks.size(); t++) {
+        if (r.blocks[t]->empty()) {
+            continue;
+        }
+        fprintf(out, "%s{\"thread\":%zu,\"metrics\":", firstThread ? "" : ",", t);
+        writeBlock(out, *r.blocks[t]);
+        fprintf(out, "}");
+        firstThread = false;
+    }
+    fprintf(out, "],\"retired\":{\"threads\":%zu,\"metrics\":", r.retiredThreads);
+    writeBlock(out, r.retired);
+    fprintf(out, "}}\n");
+    bool ok = !ferror(out);
+    if (out != stderr) {
+        ok = fclose(out) == 0 && ok;
+    }
+    return ok;
+}
+
+}  // namespace instrumentation
+
+// Counting macros; the disabled forms keep their arguments referenced
+// (unevaluated) so locals that only feed them do not trigger warnings
+#ifdef GRAPH_INSTRUMENTATION
+#define INSTRUMENT_ADD(counter, amount) \
+    instrumentation::local().add(instrumentation::Counter::counter, (uint64_t)(amount))
+#define INSTRUMENT_MAX(counter, value) \
+    instrumentation::local().raise(instrumentation::Counter::counter, (uint64_t)(value))
+#define INSTRUMENT_CLOCK(name) instrumentation::PhaseClock name
+#define INSTRUMENT_LAP(name, phase) name.lap(instrumentation::Phase::phase)
+#else
+#define INSTRUMENT_ADD(counter, amount) ((void)sizeof(amount))
+#define INSTRUMENT_MAX(counter, value) ((void)sizeof(value))
+#define INSTRUMENT_CLOCK(name) ((void)0)
+#define INSTRUMENT_LAP(name, phase) ((void)0)
+#endif
+
+#endif
@@ -1,9 +1,24 @@
 //The following code was taken from Geeks for Geeks
+#ifndef KRUSKAL_HPP
+#define KRUSKAL_HPP
+
 #include <iostream>
 #include <vector>
 #include <algorithm>
+#include <cstdint>
+#include <atomic>
+#include "thread_pool.hpp"
+#include "instrumentation.hpp"
 using namespace std;
 
+// Structure: FlatEdge
+// Packed undirected edge {u, v, w}; 12 bytes with no heap allocation
+struct FlatEdge {
+    uint32_t u;
+    uint32_t v;
+    int32_t w;
+};
+
 // Class: DSU 
 // Implements an efficient structure to track and merge disjoint sets
 class DSU {
@@ -22,7 +37,8 @@ public:
     }
     // Function: find
     // Finds the representative (root) of the set that node i belongs to
-    // Applies path compression to speed up future queries
+    // Applies iterative path halving (no recursion, so deep chains cannot
+    // overflow the stack) to speed up future queries
     // Parameters:
     // - i, node whose root set representative is to be found.
     // Returns:
@@ -30,7 +46,16 @@ public:
     // Time Complexity: O(α(V))
     // Space Complexity: O(1)
     int find(int i) {
-        return (parent[i] == i) ? i : (parent[i] = find(parent[i]));
+        unsigned depth = 0;
+        while (parent[i] != i) {
+            parent[i] = parent[parent[i]];
+            i = parent[i];
+            depth++;
+        }
+        INSTRUMENT_ADD(MstFindCalls, 1);
+        INSTRUMENT_ADD(MstFindSteps, depth);
+        INSTRUMENT_MAX(MstDeepestFind, depth);
+        return i;
     }
 
     // Function: unite
@@ -50,6 +75,73 @@ public:
     }
 };
 
+// Class: ConcurrentDSU
+// Lock-free union-find for parallel MST. Each node is one 64-bit word
+// holding {size, parent}, so a root's size is frozen the moment it is
+// linked. Roots are ordered by (size, index) and the smaller one is
+// linked under the larger with a CAS on its own word; because a linked
+// word never changes size again, two threads can never link two roots
+// under each other, so no cycles form.
+class ConcurrentDSU {
+    vector<atomic<uint64_t>> word;
+
+    static uint64_t pack(uint32_t size, uint32_t parent) { return (uint64_t(size) << 32) | parent; }
+    static uint32_t parentOf(uint64_t w) { return uint32_t(w); }
+    static uint32_t sizeOf(uint64_t w) { return uint32_t(w >> 32); }
+
+public:
+    // Constructor: ConcurrentDSU
+    // Time Complexity: O(V)
+    ConcurrentDSU(int n) : word(n) {
+        for (int i = 0; i < n; i++) word[i].store(pack(1, i), memory_order_relaxed);
+    }
+
+    // Function: find
+    // Root of i with iterative path halving; a failed halving CAS only
+    // means another thread already shortened the path
+    // Time Complexity: O(α(V)) amortized
+    uint32_t find(uint32_t i) {
+        while (true) {
+            uint64_t w = word[i].load(memory_order_acquire);
+            uint32_t p = parentOf(w);
+            if (p == i) return i;
+            uint32_t gp = parentOf(word[p].load(memory_order_acquire));
+            if (gp != p) {
+                word[i].compare_exchange_weak(w, pack(sizeOf(w), gp), memory_order_release, memory_order_relaxed);
+            }
+            i = gp;
+        }
+    }
+
+    // Function: unite
+    // Links the roots of x and y, smaller (size, index) under larger
+    // Returns:
+    // - true if this call merged two sets
+    // Time Complexity: O(α(V)) amortized, lock-free
+    bool unite(uint32_t x, uint32_t y) {
+        while (true) {
+            x = find(x);
+            y = find(y);
+            if (x == y) return false;
+            uint64_t wx = word[x].load(memory_order_acquire);
+            uint64_t wy = word[y].load(memory_order_acquire);
+            if (parentOf(wx) != x || parentOf(wy) != y) continue;
+            if (sizeOf(wx) > sizeOf(wy) || (sizeOf(wx) == sizeOf(wy) && x > y)) {
+                swap(x, y);
+                swap(wx, wy);
+            }
+            if (word[x].compare_exchange_strong(wx, pack(sizeOf(wx), y), memory_order_acq_rel)) {
+                // Size is a heuristic: give up if y was linked meanwhile
+                uint64_t w = word[y].load(memory_order_acquire);
+                while (parentOf(w) == y &&
+                       !word[y].compare_exchange_weak(w, pack(sizeOf(w) + sizeOf(wx), y), memory_order_acq_rel)) {
+                }
+                return true;
+            }
+        }
+    }
+};
+
 // Function: comparator
 // Comparison function for sorting edges by weight (ascending order)
 // Parameters:
@@ -58,37 +150,271 @@ public:
 // - true if a's weight < b's weight
 // Time Complexity: O(1)
 // Space Complexity: O(1)
-bool comparator(vector<int> &a, vector<int> &b) {
+inline bool comparator(vector<int> &a, vector<int> &b) {
     return a[2] < b[2];
 }
 
 
-// Function: kruskalsMST
-// Implements Kruskal's Algorithm to compute the Minimum Spanning Tree (MST)
-// of a weighted undirected graph
+// Function: radixSortEdges
+// Sorts edges by weight (ascending, stable) with an LSD radix sort,
+// one 8-bit digit per pass. Passes where every key shares the digit are
+// skipped, so small weight ranges cost one or two passes. Arrays above
+// parallelThreshold are histogrammed and scattered by blocks on a
+// ThreadPool; each block writes to its own precomputed offsets.
+// Parameters:
+// - edges, edges to sort in place
+// - threads, workers for large arrays (0 = hardware threads)
+// Time Complexity: O(E) per pass, at most 4 passes
+// Space Complexity: O(E)
+inline void radixSortEdges(vector<FlatEdge> &edges, unsigned threads = 0) {
+    const size_t parallelThreshold = 1 << 20;
+    size_t m = edges.size();
+    if (m < 2) return;
+
+    // Flip the sign bit so signed weights order as unsigned keys
+    auto key = [](const FlatEdge &e) { return static_cast<uint32_t>(e.w) ^ 0x80000000u; };
+    vector<FlatEdge> buffer(m);
+    FlatEdge *from = edges.data();
+    FlatEdge *to = buffer.data();
+
+    unsigned workers = 1;
+    ThreadPool *pool = nullptr;
+    ThreadPool localPool(m >= parallelThreshold ? threads : 1);
+    if (m >= parallelThreshold) {
+        pool = &localPool;
+        workers = pool->size();
+    }
+    size_t block = (m + workers - 1) / workers;
+    vector<size_t> counts(static_cast<size_t>(workers) * 256);
+
+    for (int shift = 0; shift < 32; shift += 8) {
+        fill(counts.begin(), counts.end(), 0);
+        auto histogram = [&](unsigned b) {
+            size_t begin = b * block, end = min(m, begin + block);
+            size_t *c = &counts[static_cast<size_t>(b) * 256];
+            for (size_t i = begin; i < end; i++) c[(key(from[i]) >> shift) & 0xFF]++;
+        };
+        if (pool) pool->run([&](unsigned b) { histogram(b); });
+        else histogram(0);
+
+        // Exclusive prefix over (digit, block) so equal digits keep block order
+        size_t total = 0;
+        bool single = false;
+        for (int d = 0; d < 256; d++) {
+            size_t digitTotal = 0;
+            for (unsigned b = 0; b < workers; b++) {
+                size_t c = counts[static_cast<size_t>(b) * 256 + d];
+                counts[static_cast<size_t>(b) * 256 + d] = total;
+                total += c;
+                digitTotal += c;
+            }
+            if (digitTotal == m) single = true;
+        }
+        if (single) continue;
+
+        auto scatter = [&](unsigned b) {
+            size_t begin = b * block, end = min(m, begin + block);
+            size_t *c = &counts[static_cast<size_t>(b) * 256];
+            for (size_t i = begin; i < end; i++) to[c[(key(from[i]) >> shift) & 0xFF]++] = from[i];
+        };
+        if (pool) pool->run([&](unsigned b) { scatter(b); });
+        else scatter(0);
+        swap(from, to);
+    }
+    if (from != edges.data()) edges.swap(buffer);
+}
+
+// Function: kruskalsMSTFlat
+// Kruskal's Algorithm on a packed edge array
 // Parameters:
 // - V, number of vertices.
-// - edges, list of edges where each edge is {u, v, w}.
+// - edges, packed edges; sorted by weight in place
+// - threads, workers for the radix sort (0 = hardware threads)
 // Returns:
 // - A pair containing:
-//   (1) total cost (int)
-//   (2) list of edges included in the MST (vector<vector<int>>)
-// Time Complexity: O(E log E)
+//   (1) total cost (64-bit)
+//   (2) MST edges as a flat array
+// Time Complexity: O(E + E α(V))
 // Space Complexity: O(V + E)
-pair<int, vector<vector<int>>> kruskalsMST(int V, vector<vector<int>> &edges) {
-    sort(edges.begin(), edges.end(), comparator);
+inline pair<long long, vector<FlatEdge>> kruskalsMSTFlat(int V, vector<FlatEdge> &edges, unsigned threads = 0) {
+    radixSortEdges(edges, threads);
     DSU dsu(V);
-    int cost = 0;
-    vector<vector<int>> mstEdges;
+    long long cost = 0;
+    vector<FlatEdge> mstEdges;
+    mstEdges.reserve(V > 0 ? V - 1 : 0);
 
-    for (auto &e : edges) {
-        int x = e[0], y = e[1], w = e[2];
-        if (dsu.find(x) != dsu.find(y)) {
+    size_t scanned = 0;
+    for (const auto &e : edges) {
+        scanned++;
+        int x = dsu.find(e.u), y = dsu.find(e.v);
+        if (x != y) {
             dsu.unite(x, y);
-            cost += w;
+            cost += e.w;
             mstEdges.push_back(e);
             if ((int)mstEdges.size() == V - 1) break;
         }
     }
+    INSTRUMENT_ADD(MstEdgesScanned, scanned);
     return {cost, mstEdges};
 }
+
+// Class: FilterKruskal
+// Multi-core MST by Filter-Kruskal on a ConcurrentDSU. A range is split
+// around a sampled pivot weight; the light half is solved first, then
+// heavy edges whose endpoints are already connected are filtered out
+// before the heavy half is solved. Most heavy edges never get sorted.
+// Large partitions and filters run on a ThreadPool; small ranges fall
+// back to sort + Kruskal. Every MST has the same total weight, so the
+// cost equals kruskalsMST's.
+class FilterKruskal {
+    static const size_t baseSize = 1 << 12;
+    static const size_t parallelSize = 1 << 18;
+
+    ThreadPool pool;
+    ConcurrentDSU dsu;
+    int needed;
+    long long cost = 0;
+    vector<FlatEdge> tree;
+    vector<FlatEdge> scratch;
+    vector<size_t> blockCount;
+
+    // Function: split
+    // Splits data[0, m) by keep(edge), kept edges first; with dropRest
+    // the other edges are discarded.
+    // Returns:
+    // - number of kept edges
+    template <class Keep>
+    size_t split(FlatEdge *data, size_t m, Keep keep, bool dropRest) {
+        if (m < parallelSize || pool.size() == 1) {
+            if (dropRest) return remove_if(data, data + m, [&](const FlatEdge &e) { return !keep(e); }) - data;
+            return partition(data, data + m, keep) - data;
+        }
+        unsigned blocks = pool.size();
+        size_t block = (m + blocks - 1) / blocks;
+        blockCount.assign(blocks * 2, 0);
+        pool.run([&](unsigned w) {
+            size_t begin = min(m, w * block), end = min(m, begin + block);
+            for (size_t i = begin; i < end; i++) blockCount[keep(data[i]) ? w : blocks + w]++;
+        });
+        size_t kept = 0;
+        for (unsigned w = 0; w < blocks; w++) {
+            size_t c = blockCount[w];
+            blockCount[w] = kept;
+            kept += c;
+        }
+        size_t rest = kept;
+        for (unsigned w = 0; w < blocks; w++) {
+            size_t c = blockCount[blocks + w];
+            blockCount[blocks + w] = rest;
+            rest += c;
+        }
+        if (scratch.size() < m) scratch.resize(m);
+        pool.run([&](unsigned w) {
+            size_t begin = min(m, w * block), end = min(m, begin + block);
+            size_t in = blockCount[w], out = blockCount[blocks + w];
+            for (size_t i = begin; i < end; i++) {
+                if (keep(data[i])) scratch[in++] = data[i];
+                else if (!dropRest) scratch[out++] = data[i];
+            }
+        });
+        copy(scratch.begin(), scratch.begin() + (dropRest ? kept : m), data);
+        return kept;
+    }
+
+    void kruskal(FlatEdge *data, size_t m) {
+        sort(data, data + m, [](const FlatEdge &x, const FlatEdge &y) { return x.w < y.w; });
+        for (size_t i = 0; i < m && (int)tree.size() < needed; i++) {
+            if (dsu.unite(data[i].u, data[i].v)) {
+                cost += data[i].w;
+                tree.push_back(data[i]);
+            }
+        }
+    }
+
+    void solve(FlatEdge *data, size_t m) {
+        if ((int)tree.size() >= needed || m == 0) return;
+        if (m <= baseSize) {
+            kruskal(data, m);
+            return;
+        }
+        // Median of an evenly spaced sample as the pivot
+        int32_t sample[31];
+        for (int i = 0; i < 31; i++) sample[i] = data[(m - 1) * i / 30].w;
+        nth_element(sample, sample + 15, sample + 31);
+        int32_t pivot = sample[15];
+
+        size_t light = split(data, m, [pivot](const FlatEdge &e) { return e.w <= pivot; }, false);
+        if (light == m) {
+            // Pivot is the maximum: peel off the edges strictly below it
+            light = split(data, m, [pivot](const FlatEdge &e) { return e.w < pivot; }, false);
+            if (light == 0) {
+                kruskal(data, m); // all weights equal
+                return;
+            }
+        }
+        solve(data, light);
+        if ((int)tree.size() >= needed) return;
+
+        FlatEdge *heavy = data + light;
+        size_t left = split(heavy, m - light, [this](const FlatEdge &e) { return dsu.find(e.u) != dsu.find(e.v); }, true);
+        solve(heavy, left);
+    }
+
+public:
+    FilterKruskal(int V, unsigned threads) : pool(threads), dsu(V), needed(V > 0 ? V - 1 : 0) {
+        tree.reserve(needed);
+    }
+
+    // Function: run
+    // Parameters:
+    // - edges, packed edges; reordered in place
+    // Returns:
+    // - {total cost, MST edges}
+    pair<long long, vector<FlatEdge>> run(vector<FlatEdge> &edges) {
+        solve(edges.data(), edges.size());
+        return {cost, tree};
+    }
+};
+
+// Function: filterKruskalMST
+// Multi-core MST mode; see FilterKruskal
+// Parameters:
+// - V, number of vertices.
+// - edges, packed edges; reordered in place
+// - threads, workers (0 = hardware threads)
+// Returns:
+// - A pair containing:
+//   (1) total cost (64-bit)
+//   (2) MST edges as a flat array
+// Time Complexity: O(E + V log V log(E/V)) expected
+// Space Complexity: O(V + E)
+inline pair<long long, vector<FlatEdge>> filterKruskalMST(int V, vector<FlatEdge> &edges, unsigned threads = 0) {
+    FilterKruskal solver(V, threads);
+    return solver.run(edges);
+}
+
+// Function: kruskalsMST
+// Implements Kruskal's Algorithm to compute the Minimum Spanning Tree (MST)
+// of a weighted undirected graph. Thin wrapper over kruskalsMSTFlat.
+// Parameters:
+// - V, number of vertices.
+// - edges, list of edges where each edge is {u, v, w}.
+// Returns:
+// - A pair containing:
+//   (1) total cost (int)
+//   (2) list of edges included in the MST (vector<vector<int>>)
+// Time Complexity: O(E + E α(V))
+// Space Complexity: O(V + E)
+inline pair<int, vector<vector<int>>> kruskalsMST(int V, vector<vector<int>> &edges) {
+    vector<FlatEdge> flat(edges.size());
+    for (size_t i = 0; i < edges.size(); i++) {
+        flat[i] = {(uint32_t)edges[i][0], (uint32_t)edges[i][1], (int32_t)edges[i][2]};
+    }
+    auto [cost, mst] = kruskalsMSTFlat(V, flat);
+    vector<vector<int>> mstEdges;
+    mstEdges.reserve(mst.size());
+    for (auto &e : mst) mstEdges.push_back({(int)e.u, (int)e.v, e.w});
+    return {(int)cost, mstEdges};
+}
+
+#endif
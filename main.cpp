@@ -1,11 +1,29 @@
 #include "tspNearestNeighbor.hpp"
+#include "tsp_local_search.hpp"
+#include "tsp_held_karp.hpp"
 #include "kruskal.hpp"
+#include "prim.hpp"
 #include "ford_fulkerson.hpp"
+#include "batch.hpp"
+#include "instrumentation.hpp"
+#ifdef HAVE_VORONOI
+#include "voronoi.hpp"
+#endif
 #include <fstream>
-#include <cstdlib>  
+#include <cstring>
 using namespace std;
 
-int main() {
+/*
+    Function: runStages
+    Description:
+    Runs the four stages on graph.txt, input.txt, small_instance.dimacs
+    and the sample Voronoi sites, each input loaded once.
+
+    Return value:
+    0 on success, 1 if an input cannot be read
+*/
+int runStages() {
+    INSTRUMENT_CLOCK(phases);
 
     // --- part 1 ---
     ifstream file("graph.txt");
@@ -17,27 +35,20 @@ int main() {
     int V;
     file >> V; // Read number of vertices
 
-    vector<vector<int>> matrix(V, vector<int>(V));
-    for (int i = 0; i < V; i++) {
-        for (int j = 0; j < V; j++) {
-            file >> matrix[i][j];
-        }
-    }
-
-    vector<vector<int>> edges;
-    for (int i = 0; i < V; i++) {
-        for (int j = i + 1; j < V; j++) {
-            if (matrix[i][j] != 0) {
-                edges.push_back({i, j, matrix[i][j]});
-            }
-        }
+    // Flat row-major matrix; Prim scans it directly on dense inputs
+    vector<int> matrix((size_t)V * V);
+    for (auto &w : matrix) {
+        file >> w;
     }
+    INSTRUMENT_LAP(phases, Parse);
 
-    auto [cost, mstEdges] = kruskalsMST(V, edges);
+    auto [cost, mstEdges] = mstFromMatrix(V, matrix);
+    INSTRUMENT_LAP(phases, Solve);
       cout << "\n PART 1:\n";
     for (auto &e : mstEdges) {
-        cout << e[0] << " " << e[1] << " ";;
+        cout << e.u << " " << e.v << " ";;
     }
+    INSTRUMENT_LAP(phases, Output);
     
     // --- part 2 ---
     ifstream inputFile("input.txt");
@@ -47,38 +58,114 @@ int main() {
         return 1;
     }
 
-    int n;
-    inputFile >> n;
-
-    vector<vector<int>> graph(n, vector<int>(n));
-
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j < n; j++) {
-            inputFile >> graph[i][j];
-        }
+    // Flat matrix; the nearest-neighbor scan runs on its rows with SIMD
+    DistanceMatrix<int32_t> graph;
+    if (!readDistanceMatrix(inputFile, graph)) {
+        return 1;
     }
 
     inputFile.close();
+    INSTRUMENT_LAP(phases, Parse);
+
+    // Exact for small inputs like the 4-city input.txt, heuristic otherwise
+    auto route = tspSolve(graph);
+    INSTRUMENT_LAP(phases, Solve);
+    printTSPRoute(route);
+    INSTRUMENT_LAP(phases, Output);
 
     // --- part 3 ---
     
-    readFile("small_instance.dimacs");
-    if (source == -1 || sink == -1) {
+    FlowNetwork network;
+    DimacsLoadStats loadStats;
+    if (!readFlowNetwork("small_instance.dimacs", network, &loadStats) ||
+        network.source == -1 || network.sink == -1) {
         return 1;
     }
-    int maxFlow = edmondsKarp(n, source, sink);
+    std::cerr << "Parsed " << loadStats.bytes << " bytes at "
+              << loadStats.megabytesPerSecond() << " MB/s\n";
+    INSTRUMENT_LAP(phases, Parse);
+    MaxFlowSolver solver(network.nodes, network.arcs);
+    INSTRUMENT_LAP(phases, Build);
+    long long maxFlow = solver.solve(network.source, network.sink);
+    INSTRUMENT_LAP(phases, Solve);
     std::cout << "The maximum possible flow is " << maxFlow << std::endl;
+    INSTRUMENT_LAP(phases, Output);
+
+    // --- part 4 ---
+    cout << "\n PART 4:\n";
+#ifdef HAVE_VORONOI
+    // Linked in from the voronoi_diagram library, same process
+    vector<SitePoint> sites = sampleVoronoiSites();
+    for (const auto &corner : boundingSites(siteBounds(sites))) {
+        sites.push_back(corner);
+    }
+    vector<Point2> points = toPoints(sites);
+    VoronoiDiagram diagram = buildVoronoiDiagram(points);
+    INSTRUMENT_LAP(phases, Build);
+    displayVoronoiDiagram(diagram, points);
+    INSTRUMENT_LAP(phases, Output);
+#else
+    cerr << "Voronoi diagram skipped: built without CGAL\n";
+#endif
+
     return 0;
+}
+
+/*
+    Function: main
+    Description:
+    Runs the four stages, or a batch of jobs with --batch.
 
+    Parameters:
+    --batch: JSONL job manifest (see batch.hpp)
+    --workers: jobs run at the same time (default: hardware threads)
+    --output: result file for --batch (default: standard output)
+    --metrics: JSON report of phase times, peak memory and the hot-path
+    counters of a GRAPH_INSTRUMENTATION build ("-" = standard error)
 
-    tspRepetitiveNearestNeighbor(n, graph);
-     cout << "\n PART 4:\n";
-//  --- Part 4 ---
-    int ret = system(".\\build\\Release\\voronoi.exe"); // Para Windows
-    if (ret != 0) {
-        std::cerr << "Error al ejecutar voronoi.exe\n";
+    Return value:
+    0 on success, 1 if an input cannot be read or a batch job fails
+*/
+int main(int argc, char *argv[]) {
+    // main [--batch manifest.jsonl [--workers N] [--output results.jsonl]] [--metrics report.json]
+    const char *manifest = nullptr;
+    const char *outputFile = nullptr;
+    const char *metricsFile = nullptr;
+    unsigned workers = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--batch") == 0 && i + 1 < argc) {
+            manifest = argv[++i];
+        } else if (strcmp(argv[i], "--workers") == 0 && i + 1 < argc) {
+            workers = (unsigned)atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            outputFile = argv[++i];
+        } else if (strcmp(argv[i], "--metrics") == 0 && i + 1 < argc) {
+            metricsFile = argv[++i];
+        } else {
+            cerr << "Error: unknown argument " << argv[i] << "\n";
+            return 1;
+        }
     }
-    return 0;
 
-    return 0;
+    int status;
+    if (manifest != nullptr) {
+        FILE *out = outputFile ? fopen(outputFile, "wb") : stdout;
+        if (out == nullptr) {
+            cerr << "Error: could not open " << outputFile << "\n";
+            return 1;
+        }
+        bool ok = runBatch(manifest, out, workers);
+        if (out != stdout) {
+            ok = fclose(out) == 0 && ok;
+        }
+        status = ok ? 0 : 1;
+    } else {
+        status = runStages();
+    }
+
+    if (metricsFile != nullptr && !instrumentation::writeMetricsReport(metricsFile)) {
+        cerr << "Error: could not write metrics to " << metricsFile << "\n";
+        return 1;
+    }
+    return status;
 }
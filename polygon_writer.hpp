@@ -0,0 +1,215 @@
+/*
+    Polygon writer
+    Description:
+    Streams Voronoi sites and cell polygons to a file as JSON or as a
+    compact binary format. Polygons are collected into flat vertex and
+    size buffers. Whenever a chunk fills up it is formatted into one
+    large output buffer and written, so memory stays bounded however big
+    the diagram is. Numbers are formatted with std::to_chars (shortest
+    round-trip form), never through iostreams.
+
+    Binary layout (little-endian, as written by the host):
+    "VPL1", uint64 site count, site count (x, y) doubles, then chunks of
+    uint32 polygon count, uint32 vertex count, one uint32 size per
+    polygon and vertex count (x, y) doubles. A chunk with polygon count 0
+    ends the stream.
+
+    JSON layout:
+    {"sites":[[x,y],...],"polygons":[[[x,y],...],...]}
+
+    Non-finite coordinates are rejected in both formats: JSON has no
+    literal for them, so they are written as null, the binary stream
+    keeps the raw doubles, and finish() reports failure either way.
+*/
+
+#ifndef POLYGON_WRITER_HPP
+#define POLYGON_WRITER_HPP
+
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <charconv>
+#include <cmath>
+#include <vector>
+using namespace std;
+
+/*
+    Class: OutputBuffer
+    Description:
+    Append-only byte buffer in front of a FILE*, flushed when full.
+*/
+class OutputBuffer {
+public:
+    OutputBuffer(FILE *out, size_t capacity = 1 << 20) : out(out), buffer(capacity) {}
+    ~OutputBuffer() { flush(); }
+
+    OutputBuffer(const OutputBuffer &) = delete;
+    OutputBuffer &operator=(const OutputBuffer &) = delete;
+
+    void write(const void *data, size_t length) {
+        if (used + length > buffer.size()) {
+            flush();
+            if (length > buffer.size()) {
+                ok = fwrite(data, 1, length, out) == length && ok;
+                return;
+            }
+        }
+        memcpy(&buffer[used], data, length);
+        used += length;
+    }
+
+    void put(char c) {
+        if (used == buffer.size()) flush();
+        buffer[used++] = c;
+    }
+
+    void number(double value) {
+        if (buffer.size() - used < 32) flush();
+        if (!isfinite(value)) {
+            write("null", 4);
+            return;
+        }
+        auto result = to_chars(&buffer[used], &buffer[0] + buffer.size(), value);
+        used = result.ptr - &buffer[0];
+    }
+
+    void flush() {
+        if (used > 0) {
+            ok = fwrite(buffer.data(), 1, used, out) == used && ok;
+            used = 0;
+        }
+    }
+
+    bool good() const { return ok; }
+
+private:
+    FILE *out;
+    vector<char> buffer;
+    size_t used = 0;
+    bool ok = true;
+};
+
+/*
+    Class: PolygonWriter
+    Description:
+    Write the sites once, then the polygons one vertex at a time, then
+    call finish().
+*/
+class PolygonWriter {
+public:
+    enum class Format {
+        Binary,
+        Json
+    };
+
+    // Constructor: PolygonWriter
+    // Parameters:
+    // - out, open output file
+    // - format, Binary or Json
+    // - chunkVertices, vertices buffered before a chunk is written
+    PolygonWriter(FILE *out, Format format, size_t chunkVertices = 1 << 16)
+        : buffer(out), format(format), chunkVertices(chunkVertices) {}
+
+    // Function: writeSites
+    // Writes count sites from interleaved (x, y) coordinates; call once,
+    // before any polygon
+    void writeSites(const double *xy, size_t count) {
+        for (size_t i = 0; i < 2 * count; i++) {
+            finite = finite && isfinite(xy[i]);
+        }
+        if (format == Format::Binary) {
+            uint64_t n = count;
+            buffer.write("VPL1", 4);
+            buffer.write(&n, sizeof n);
+            buffer.write(xy, count * 2 * sizeof(double));
+            return;
+        }
+        buffer.write("{\"sites\":[", 10);
+        for (size_t i = 0; i < count; i++) {
+            if (i > 0) buffer.put(',');
+            point(xy[2 * i], xy[2 * i + 1]);
+        }
+        buffer.write("],\"polygons\":[", 14);
+    }
+
+    void beginPolygon() { sizes.push_back(0); }
+
+    void addVertex(double x, double y) {
+        finite = finite && isfinite(x) && isfinite(y);
+        coordinates.push_back(x);
+        coordinates.push_back(y);
+        sizes.back()++;
+    }
+
+    void endPolygon() {
+        if (coordinates.size() / 2 >= chunkVertices) {
+            writeChunk();
+        }
+    }
+
+    // Function: finish
+    // Writes the remaining polygons and the closing marker
+    // Returns:
+    // - true if every write succeeded and every coordinate was finite
+    bool finish() {
+        writeChunk();
+        if (format == Format::Binary) {
+            uint32_t end[2] = {0, 0};
+            buffer.write(end, sizeof end);
+        } else {
+            buffer.write("]}\n", 3);
+        }
+        buffer.flush();
+        if (!finite) {
+            fputs("Error: the polygons have a non-finite coordinate\n", stderr);
+        }
+        return buffer.good() && finite;
+    }
+
+    size_t polygonCount() const { return polygons + sizes.size(); }
+
+private:
+    OutputBuffer buffer;
+    Format format;
+    size_t chunkVertices;
+    vector<double> coordinates;   // interleaved x, y of the current chunk
+    vector<uint32_t> sizes;       // vertices per polygon of the current chunk
+    size_t polygons = 0;          // polygons already written
+    bool finite = true;           // no NaN or infinite coordinate so far
+
+    void point(double x, double y) {
+        buffer.put('[');
+        buffer.number(x);
+        buffer.put(',');
+        buffer.number(y);
+        buffer.put(']');
+    }
+
+    void writeChunk() {
+        if (sizes.empty()) {
+            return;
+        }
+        if (format == Format::Binary) {
+            uint32_t header[2] = {(uint32_t)sizes.size(), (uint32_t)(coordinates.size() / 2)};
+            buffer.write(header, sizeof header);
+            buffer.write(sizes.data(), sizes.size() * sizeof(uint32_t));
+            buffer.write(coordinates.data(), coordinates.size() * sizeof(double));
+        } else {
+            const double *xy = coordinates.data();
+            for (size_t p = 0; p < sizes.size(); p++) {
+                if (polygons + p > 0) buffer.put(',');
+                buffer.write("\n[", 2);
+                for (uint32_t v = 0; v < sizes[p]; v++, xy += 2) {
+                    if (v > 0) buffer.put(',');
+                    point(xy[0], xy[1]);
+                }
+                buffer.put(']');
+            }
+        }
+        polygons += sizes.size();
+        sizes.clear();
+        coordinates.clear();
+    }
+};
+
+#endif
@@ -0,0 +1,84 @@
+// Batch mode: jobs run through runBatchJob with one reused arena, and
+// their result lines are checked against the engines called directly or
+// against the expected error.
+
+#include "batch.hpp"
+#include "instance_generators.hpp"
+#include "test_support.hpp"
+using namespace std;
+
+// Runs one manifest line and returns its result line
+string runLine(const string &line, BatchArena &arena, bool &ok) {
+    BatchJob job;
+    job.line = 1;
+    parseBatchJob(line, job);
+    ok = runBatchJob(job, arena);
+    return arena.result;
+}
+
+bool contains(const string &text, const string &part) {
+    return text.find(part) != string::npos;
+}
+
+// MST jobs on text and binary edge lists
+void checkEdgeListJobs() {
+    BatchArena arena;
+    bool ok = false;
+    for (uint64_t seed = 1; seed <= 3; seed++) {
+        int V = 500;
+        vector<FlatEdge> input = geometricGraph(V, 6, seed);
+        vector<FlatEdge> edges = input;
+        long long cost = kruskalsMSTFlat(V, edges).first;
+        string expected = "\"result\":{\"cost\":" + to_string(cost) + ",";
+
+        string text = to_string(V) + " " + to_string(input.size()) + "\n";
+        for (const FlatEdge &e : input) {
+            text += to_string(e.u) + " " + to_string(e.v) + " " + to_string(e.w) + "\n";
+        }
+        writeTextFile("batch_edges.txt", text);
+        CHECK(writeBinaryEdgeList("batch_edges.bin", V, input));
+        for (const char *filename : {"batch_edges.txt", "batch_edges.bin"}) {
+            string result = runLine(string("{\"type\":\"mst\",\"format\":\"edges\",\"input\":\"") + filename + "\"}",
+                                    arena, ok);
+            CHECK(ok);
+            CHECK(contains(result, expected));
+        }
+    }
+
+    writeTextFile("batch_bad_edges.txt", "3 2\n0 1 5\n1 7 5\n");
+    string result = runLine("{\"type\":\"mst\",\"format\":\"edges\",\"input\":\"batch_bad_edges.txt\"}", arena, ok);
+    CHECK(!ok);
+    CHECK(contains(result, "\"error\":\"could not read the edge list\""));
+    result = runLine("{\"type\":\"mst\",\"format\":\"csv\",\"input\":\"batch_edges.txt\"}", arena, ok);
+    CHECK(!ok);
+    CHECK(contains(result, "\"error\":\"format must be matrix or edges\""));
+}
+
+// Inputs too large to load end as error lines, and a job that throws
+// does not stop the next one on the same arena
+void checkOversizedJobs() {
+    BatchArena arena;
+    bool ok = true;
+    writeTextFile("batch_huge_matrix.txt", "2000000000\n0 1\n1 0\n");
+    string result = runLine("{\"type\":\"mst\",\"input\":\"batch_huge_matrix.txt\"}", arena, ok);
+    CHECK(!ok);
+    CHECK(contains(result, "\"error\":\"matrix size exceeds the file\""));
+    CHECK(arena.matrix.capacity() < 1000);
+
+    // readDistanceMatrix does not bound n, so the allocation throws
+    writeTextFile("batch_huge_tsp.txt", "2000000000\n");
+    result = runLine("{\"id\":\"huge\",\"type\":\"tsp\",\"input\":\"batch_huge_tsp.txt\"}", arena, ok);
+    CHECK(!ok);
+    CHECK(contains(result, "\"id\":\"huge\",\"type\":\"tsp\",\"status\":\"error\",\"error\":\"exception: "));
+
+    writeTextFile("batch_small_matrix.txt", "2\n0 3\n3 0\n");
+    result = runLine("{\"type\":\"mst\",\"input\":\"batch_small_matrix.txt\"}", arena, ok);
+    CHECK(ok);
+    CHECK(contains(result, "\"result\":{\"cost\":3,"));
+}
+
+int main() {
+    checkEdgeListJobs();
+    checkOversizedJobs();
+    return testResult("batch_test");
+}
@@ -0,0 +1,40 @@
+// Cross-check of GomoryHuTree::minCut against a direct max flow for
+// every pair of vertices on seeded random undirected networks.
+
+#include "gomory_hu.hpp"
+#include "instance_generators.hpp"
+#include "test_support.hpp"
+using namespace std;
+
+int main() {
+    mt19937_64 rng(5);
+    for (int instance = 0; instance < 300; instance++) {
+        int nodes = (int)rangeRandom(rng, 1, 10);
+        vector<FlowArc> edges;
+        int count = (int)rangeRandom(rng, 0, 25);
+        for (int i = 0; i < count; i++) {
+            edges.push_back({(int)rangeRandom(rng, 0, nodes - 1), (int)rangeRandom(rng, 0, nodes - 1),
+                             rangeRandom(rng, 0, 30)});
+        }
+        vector<FlowArc> arcs;
+        for (const FlowArc &e : edges) {
+            arcs.push_back(e);
+            arcs.push_back({e.to, e.from, e.capacity});
+        }
+
+        GomoryHuTree tree;
+        tree.build(nodes, edges, 1 + instance % 4);
+        CHECK_EQUAL(tree.nodeCount(), nodes);
+        MaxFlowSolver solver(nodes, arcs);
+        for (int u = 0; u < nodes; u++) {
+            CHECK_EQUAL(tree.minCut(u, u), LLONG_MAX);
+            for (int v = u + 1; v < nodes; v++) {
+                solver.reset();
+                long long expected = solver.solve(u, v);
+                CHECK_EQUAL(tree.minCut(u, v), expected);
+                CHECK_EQUAL(tree.minCut(v, u), expected);
+            }
+        }
+    }
+    return testResult("gomory_hu_test");
+}
@@ -0,0 +1,55 @@
+// Instrumentation registry: blocks of exited threads are merged into the
+// retired total and freed, and the report still counts them. Built with
+// GRAPH_INSTRUMENTATION whatever the project option says.
+
+#include <thread>
+#include "instrumentation.hpp"
+#include "thread_pool.hpp"
+#include "test_support.hpp"
+using namespace std;
+
+size_t liveBlocks() {
+    instrumentation::Registry &r = instrumentation::registry();
+    lock_guard<mutex> guard(r.lock);
+    return r.blocks.size();
+}
+
+// Many short-lived threads and pools leave the registry at its size
+// before they started, with their counts in the retired total (the
+// calling thread is worker 0 of each pool and stays live)
+void checkRetiredThreads() {
+    INSTRUMENT_ADD(TspTours, 1);
+    size_t before = liveBlocks();
+    for (int round = 0; round < 50; round++) {
+        thread worker([round]() {
+            INSTRUMENT_ADD(MstFindCalls, 3);
+            INSTRUMENT_MAX(MstDeepestFind, round);
+        });
+        worker.join();
+        ThreadPool pool(4);
+        pool.run([](unsigned) { INSTRUMENT_ADD(MstFindCalls, 1); });
+    }
+    CHECK_EQUAL(liveBlocks(), before);
+
+    instrumentation::Registry &r = instrumentation::registry();
+    lock_guard<mutex> guard(r.lock);
+    CHECK_EQUAL(r.retired.counters[(int)instrumentation::Counter::MstFindCalls], (uint64_t)(50 * 3 + 50 * 3));
+    CHECK_EQUAL(r.retired.counters[(int)instrumentation::Counter::MstDeepestFind], (uint64_t)49);
+    CHECK_EQUAL(r.retiredThreads, (size_t)(50 + 50 * 3));
+}
+
+// The report totals include the retired threads
+void checkReport() {
+    CHECK(instrumentation::writeMetricsReport("instrumentation_report.json"));
+    ifstream in("instrumentation_report.json");
+    string report((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+    CHECK(report.find("\"total\":{\"phases\"") != string::npos);
+    CHECK(report.find("\"mst.find_calls\":350") != string::npos);
+    CHECK(report.find("\"retired\":{\"threads\":200,") != string::npos);
+}
+
+int main() {
+    checkRetiredThreads();
+    checkReport();
+    return testResult("instrumentation_test");
+}
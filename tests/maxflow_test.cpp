@@ -0,0 +1,235 @@
+// Cross-checks for the max flow engines in ford_fulkerson.hpp on seeded
+// random instances: every MaxFlowSolver mode must agree with the
+// matrix-based Edmonds-Karp and leave a feasible flow behind.
+
+#include "ford_fulkerson.hpp"
+#include "instance_generators.hpp"
+#include "test_support.hpp"
+using namespace std;
+
+// Random network with parallel arcs, self-loops and arcs into the
+// source or out of the sink, which the CSR layout has to tolerate
+FlowNetwork randomFlowNetwork(mt19937_64 &rng, int maxNodes, int maxArcs, long long maxCapacity) {
+    FlowNetwork network;
+    network.nodes = (int)rangeRandom(rng, 2, maxNodes);
+    network.source = 0;
+    network.sink = network.nodes - 1;
+    int arcs = (int)rangeRandom(rng, 0, maxArcs);
+    for (int i = 0; i < arcs; i++) {
+        int from = (int)rangeRandom(rng, 0, network.nodes - 1);
+        int to = (int)rangeRandom(rng, 0, network.nodes - 1);
+        network.arcs.push_back({from, to, rangeRandom(rng, 0, maxCapacity)});
+    }
+    return network;
+}
+
+// Reference value from the matrix-based Edmonds-Karp
+long long referenceMaxFlow(const FlowNetwork &network) {
+    ResidualMatrix graph;
+    buildResidualMatrix(network, graph);
+    return edmondsKarp(graph, network.source, network.sink);
+}
+
+// Capacity bounds and conservation of the flow left in the solver, and
+// a cut of the same value on the residual source side
+void checkFeasibleFlow(MaxFlowSolver &solver, const FlowNetwork &network, long long value) {
+    vector<long long> balance(network.nodes, 0);
+    for (size_t i = 0; i < network.arcs.size(); i++) {
+        const FlowArc &arc = network.arcs[i];
+        long long flow = solver.flowOn(i);
+        CHECK(flow >= 0 && flow <= arc.capacity);
+        balance[arc.from] -= flow;
+        balance[arc.to] += flow;
+    }
+    for (int v = 0; v < network.nodes; v++) {
+        if (v != network.source && v != network.sink) {
+            CHECK_EQUAL(balance[v], 0LL);
+        }
+    }
+    CHECK_EQUAL(balance[network.sink], value);
+
+    vector<char> side;
+    solver.sourceSide(network.source, side);
+    CHECK(!side[network.sink]);
+    long long cut = 0;
+    for (const FlowArc &arc : network.arcs) {
+        if (side[arc.from] && !side[arc.to]) {
+            cut += arc.capacity;
+        }
+    }
+    CHECK_EQUAL(cut, value);
+}
+
+// Dinic and the CSR Edmonds-Karp mode against the matrix reference
+void checkDinicAndEdmondsKarp() {
+    mt19937_64 rng(1);
+    for (int instance = 0; instance < 500; instance++) {
+        FlowNetwork network = randomFlowNetwork(rng, 12, 40, 20);
+        long long expected = referenceMaxFlow(network);
+        for (auto algorithm : {MaxFlowSolver::Algorithm::Dinic, MaxFlowSolver::Algorithm::EdmondsKarp}) {
+            MaxFlowSolver solver(network.nodes, network.arcs);
+            long long value = solver.solve(network.source, network.sink, algorithm);
+            CHECK_EQUAL(value, expected);
+            CHECK_EQUAL(solver.flowValue(network.source), expected);
+            checkFeasibleFlow(solver, network, value);
+        }
+    }
+}
+
+// Multithreaded push-relabel with 1, 2 and 4 workers
+void checkPushRelabel() {
+    mt19937_64 rng(3);
+    for (int instance = 0; instance < 300; instance++) {
+        FlowNetwork network = randomFlowNetwork(rng, 16, 60, 20);
+        long long expected = referenceMaxFlow(network);
+        for (unsigned threads : {1u, 2u, 4u}) {
+            MaxFlowSolver solver(network.nodes, network.arcs);
+            solver.setThreads(threads);
+            long long value = solver.solve(network.source, network.sink, MaxFlowSolver::Algorithm::PushRelabel);
+            CHECK_EQUAL(value, expected);
+            checkFeasibleFlow(solver, network, value);
+        }
+    }
+    for (uint64_t seed = 1; seed <= 3; seed++) {
+        FlowNetwork network = layeredFlowNetwork(8, 20, 4, seed);
+        long long expected = referenceMaxFlow(network);
+        MaxFlowSolver solver(network.nodes, network.arcs);
+        solver.setThreads(4);
+        CHECK_EQUAL(solver.solve(network.source, network.sink, MaxFlowSolver::Algorithm::PushRelabel), expected);
+        checkFeasibleFlow(solver, network, expected);
+    }
+}
+
+// Structured instances from the benchmark generators
+void checkGeneratedNetworks() {
+    for (uint64_t seed = 1; seed <= 5; seed++) {
+        for (const FlowNetwork &network : {gridFlowNetwork(6, 7, seed), layeredFlowNetwork(5, 6, 3, seed)}) {
+            long long expected = referenceMaxFlow(network);
+            MaxFlowSolver solver(network.nodes, network.arcs);
+            CHECK_EQUAL(solver.solve(network.source, network.sink), expected);
+            checkFeasibleFlow(solver, network, expected);
+        }
+    }
+}
+
+// Warm-started solves after random capacity increases, decreases and
+// new arcs, against a from-scratch solve of the updated network
+void checkIncrementalUpdates() {
+    mt19937_64 rng(4);
+    const MaxFlowSolver::Algorithm algorithms[] = {MaxFlowSolver::Algorithm::Dinic,
+                                                   MaxFlowSolver::Algorithm::EdmondsKarp,
+                                                   MaxFlowSolver::Algorithm::PushRelabel};
+    for (int instance = 0; instance < 300; instance++) {
+        FlowNetwork network = randomFlowNetwork(rng, 12, 40, 20);
+        MaxFlowSolver solver(network.nodes, network.arcs);
+        long long value = solver.solve(network.source, network.sink);
+        for (int update = 0; update < 10; update++) {
+            if (network.arcs.empty() || rng() % 4 == 0) {
+                FlowArc arc{(int)rangeRandom(rng, 0, network.nodes - 1), (int)rangeRandom(rng, 0, network.nodes - 1),
+                            rangeRandom(rng, 0, 20)};
+                CHECK_EQUAL(solver.addArc(arc.from, arc.to, arc.capacity), network.arcs.size());
+                network.arcs.push_back(arc);
+            } else {
+                size_t i = rng() % network.arcs.size();
+                network.arcs[i].capacity = rangeRandom(rng, 0, 20);
+                CHECK(solver.setCapacity(i, network.arcs[i].capacity));
+            }
+            value += solver.solve(network.source, network.sink, algorithms[update % 3]);
+            long long expected = referenceMaxFlow(network);
+            CHECK_EQUAL(value, expected);
+            CHECK_EQUAL(solver.flowValue(network.source), expected);
+            checkFeasibleFlow(solver, network, expected);
+        }
+    }
+}
+
+// Invalid incremental updates are rejected without touching the graph
+void checkUpdateValidation() {
+    FlowNetwork network = gridFlowNetwork(3, 4, 7);
+    long long expected = referenceMaxFlow(network);
+    MaxFlowSolver solver(network.nodes, network.arcs);
+    size_t arcs = solver.arcCount();
+    CHECK(!solver.setCapacity(arcs, 5));
+    CHECK(!solver.setCapacity(0, -1));
+    CHECK_EQUAL(solver.addArc(-1, 0, 5), MaxFlowSolver::invalidArc);
+    CHECK_EQUAL(solver.addArc(0, network.nodes, 5), MaxFlowSolver::invalidArc);
+    CHECK_EQUAL(solver.addArc(0, 1, -5), MaxFlowSolver::invalidArc);
+    CHECK_EQUAL(solver.arcCount(), arcs);
+    CHECK_EQUAL(solver.capacityOf(0), network.arcs[0].capacity);
+    CHECK_EQUAL(solver.solve(network.source, network.sink), expected);
+    checkFeasibleFlow(solver, network, expected);
+}
+
+// Parses text through the streaming (stdin / pipe) path
+bool readThroughStream(const string &text, FlowNetwork &network) {
+    FILE *in = tmpfile();
+    if (in == nullptr) {
+        return false;
+    }
+    fwrite(text.data(), 1, text.size(), in);
+    rewind(in);
+    network = FlowNetwork();
+    DimacsParser parser(network);
+    DimacsLoadStats stats;
+    bool ok = readFlowNetworkStream(in, parser, stats);
+    fclose(in);
+    parser.finish();
+    return ok && parser.complete();
+}
+
+// DIMACS loader: a valid file, and inputs that must be rejected by both
+// the mapped and the streaming path
+void checkDimacsLoader() {
+    FlowNetwork network;
+    writeTextFile("loader_valid.dimacs", "c sample\np max 3 2\nn 1 s\nn 3 t\na 1 2 9223372036854775807\na 2 3 0\n");
+    CHECK(readFlowNetwork("loader_valid.dimacs", network));
+    CHECK_EQUAL(network.nodes, 3);
+    CHECK_EQUAL(network.source, 0);
+    CHECK_EQUAL(network.sink, 2);
+    CHECK_EQUAL(network.arcs.size(), (size_t)2);
+    CHECK_EQUAL(network.arcs[0].capacity, LLONG_MAX);
+
+    // Capacities past 32 bits keep their value in the matrix engine,
+    // including parallel arcs that only sum past 32 bits
+    writeTextFile("loader_wide.dimacs", "p max 3 4\nn 1 s\nn 3 t\na 1 2 3000000000\na 1 2 3000000000\n"
+                                        "a 2 3 5000000000\na 2 3 2147483648\n");
+    ResidualMatrix wide;
+    CHECK(readFile("loader_wide.dimacs", wide));
+    CHECK_EQUAL(wide.capacity[0][1], 6000000000LL);
+    CHECK_EQUAL(edmondsKarp(wide, wide.source, wide.sink), 6000000000LL);
+
+    const char *rejected[] = {
+        "a 1 2 5\np max 2 1\n",                    // arc before the problem line
+        "n 1 s\np max 2 0\n",                      // node line before the problem line
+        "p max 2 1\na 1 2 -5\n",                   // negative capacity
+        "p max 2 1\na 1 2 9223372036854775808\n",  // capacity overflow
+        "p max 99999999999999999999 1\n",          // node count overflow
+        "p max 3000000000 1\n",                    // more nodes than an int holds
+        "p max 2 1\na 1 3 5\n",                    // node out of range
+        "p max 2 1\nn 0 s\n",                      // node id out of range
+        "p max 2 4000000000000\na 1 2 5\n",        // far fewer arcs than declared
+        "p max 2 3\na 1 2 5\na 2 1 5\n",            // truncated arc list
+    };
+    int index = 0;
+    for (const char *text : rejected) {
+        string filename = "loader_rejected_" + to_string(index++) + ".dimacs";
+        writeTextFile(filename, text);
+        CHECK(!readFlowNetwork(filename, network));
+        CHECK(!readThroughStream(text, network));
+    }
+    CHECK(network.arcs.capacity() <= DimacsParser::streamReserveArcs);
+
+    CHECK(readThroughStream("p max 3 2\nn 1 s\nn 3 t\na 1 2 4\na 2 3 6\n", network));
+    CHECK_EQUAL(network.arcs.size(), (size_t)2);
+    CHECK_EQUAL(network.sink, 2);
+}
+
+int main() {
+    checkDimacsLoader();
+    checkDinicAndEdmondsKarp();
+    checkPushRelabel();
+    checkGeneratedNetworks();
+    checkIncrementalUpdates();
+    checkUpdateValidation();
+    return testResult("maxflow_test");
+}
@@ -0,0 +1,214 @@
+// Cross-checks for the MST engines on seeded random graphs: every engine
+// must return a spanning forest of the input with the reference cost.
+
+#include "kruskal.hpp"
+#include "prim.hpp"
+#include "external_mst.hpp"
+#include "dynamic_mst.hpp"
+#include "instance_generators.hpp"
+#include "test_support.hpp"
+using namespace std;
+
+// Random multigraph with self-loops, repeated weights and possibly
+// several components
+vector<FlatEdge> randomEdges(mt19937_64 &rng, int V, int maxEdges, int maxWeight) {
+    vector<FlatEdge> edges((size_t)rangeRandom(rng, 0, maxEdges));
+    for (auto &e : edges) {
+        e = {(uint32_t)rangeRandom(rng, 0, V - 1), (uint32_t)rangeRandom(rng, 0, V - 1),
+             (int32_t)rangeRandom(rng, 1, maxWeight)};
+    }
+    return edges;
+}
+
+// Reference MST cost: comparison sort and the sequential DSU
+long long referenceCost(int V, vector<FlatEdge> edges, int &treeEdges) {
+    stable_sort(edges.begin(), edges.end(), [](const FlatEdge &a, const FlatEdge &b) { return a.w < b.w; });
+    DSU dsu(V);
+    long long cost = 0;
+    treeEdges = 0;
+    for (const FlatEdge &e : edges) {
+        if (dsu.find(e.u) != dsu.find(e.v)) {
+            dsu.unite(e.u, e.v);
+            cost += e.w;
+            treeEdges++;
+        }
+    }
+    return cost;
+}
+
+// The tree has the reference cost and size, is acyclic and only uses
+// edges of the input
+void checkForest(int V, const vector<FlatEdge> &input, const pair<long long, vector<FlatEdge>> &result) {
+    int treeEdges = 0;
+    long long expected = referenceCost(V, input, treeEdges);
+    CHECK_EQUAL(result.first, expected);
+    CHECK_EQUAL(result.second.size(), (size_t)treeEdges);
+
+    vector<FlatEdge> sorted = input;
+    auto key = [](const FlatEdge &e) { return make_tuple(min(e.u, e.v), max(e.u, e.v), e.w); };
+    sort(sorted.begin(), sorted.end(), [&](const FlatEdge &a, const FlatEdge &b) { return key(a) < key(b); });
+    DSU dsu(V);
+    long long cost = 0;
+    for (const FlatEdge &e : result.second) {
+        CHECK(binary_search(sorted.begin(), sorted.end(), e,
+                            [&](const FlatEdge &a, const FlatEdge &b) { return key(a) < key(b); }));
+        CHECK(dsu.find(e.u) != dsu.find(e.v));
+        dsu.unite(e.u, e.v);
+        cost += e.w;
+    }
+    CHECK_EQUAL(cost, expected);
+}
+
+// Filter-Kruskal on 1-8 threads and the radix-sorted Kruskal
+void checkFilterKruskal() {
+    mt19937_64 rng(7);
+    for (int instance = 0; instance < 400; instance++) {
+        int V = (int)rangeRandom(rng, 1, 60);
+        vector<FlatEdge> input = randomEdges(rng, V, 300, instance % 2 ? 10 : 100000);
+        vector<FlatEdge> edges = input;
+        checkForest(V, input, kruskalsMSTFlat(V, edges));
+        edges = input;
+        checkForest(V, input, filterKruskalMST(V, edges, 1 + instance % 8));
+    }
+    // Large enough for the parallel partition and filter passes
+    int V = 60000;
+    vector<FlatEdge> input = geometricGraph(V, 10, 7);
+    for (unsigned threads : {1u, 2u, 4u}) {
+        vector<FlatEdge> edges = input;
+        checkForest(V, input, filterKruskalMST(V, edges, threads));
+    }
+}
+
+// Text edge list in the readEdgeList format
+string edgeListText(int V, const vector<FlatEdge> &edges) {
+    string text = to_string(V) + " " + to_string(edges.size()) + "\n";
+    for (const FlatEdge &e : edges) {
+        text += to_string(e.u) + " " + to_string(e.v) + " " + to_string(e.w) + "\n";
+    }
+    return text;
+}
+
+// Text and binary edge lists, loaded whole and through external-memory
+// Kruskal with a multi-run (24 KiB) and a single-run budget
+void checkEdgeLists() {
+    for (uint64_t seed = 1; seed <= 4; seed++) {
+        int V = 3000;
+        vector<FlatEdge> input = geometricGraph(V, 6, seed);
+        writeTextFile("edges.txt", edgeListText(V, input));
+        CHECK(writeBinaryEdgeList("edges.bin", V, input));
+        for (const char *filename : {"edges.txt", "edges.bin"}) {
+            int readV = 0;
+            vector<FlatEdge> edges;
+            CHECK(readEdgeList(filename, readV, edges));
+            CHECK_EQUAL(readV, V);
+            CHECK_EQUAL(edges.size(), input.size());
+            checkForest(V, input, kruskalsMSTFlat(V, edges));
+            for (size_t budget : {(size_t)24 << 10, (size_t)64 << 20}) {
+                checkForest(V, input, externalKruskalMST(filename, budget, readV));
+                CHECK_EQUAL(readV, V);
+            }
+        }
+    }
+}
+
+// Edge lists that must be rejected instead of loaded partially
+void checkRejectedEdgeLists() {
+    const char *rejected[] = {
+        "3 1000000000\n0 1 5\n",    // more edges than the file can hold
+        "3 2\n0 1 5\n1 3 5\n",      // endpoint out of range
+        "3 2\n0 1 5\n-1 2 5\n",     // negative endpoint
+        "3 2\n0 1 5\n1 x 5\n",      // parse failure
+        "3 2\n0 1 5\n1 2\n",        // missing weight
+        "3 3\n0 1 5\n1 2 5\n",      // fewer edges than declared
+        "3 1\n0 1 9999999999\n",     // weight beyond 32 bits
+        "-3 1\n0 1 5\n",             // negative vertex count
+    };
+    int index = 0;
+    for (const char *text : rejected) {
+        string filename = "rejected_" + to_string(index++) + ".txt";
+        writeTextFile(filename, text);
+        int V = 0;
+        vector<FlatEdge> edges;
+        CHECK(!readEdgeList(filename, V, edges));
+        CHECK(externalKruskalMST(filename, 1 << 20, V).second.empty());
+    }
+
+    vector<FlatEdge> edges = {{0, 1, 5}, {1, 2, 7}};
+    CHECK(writeBinaryEdgeList("rejected_range.bin", 2, edges));
+    int V = 0;
+    CHECK(!readEdgeList("rejected_range.bin", V, edges));
+    CHECK(writeBinaryEdgeList("rejected_short.bin", 3, edges));
+    string bytes;
+    {
+        ifstream in("rejected_short.bin", ios::binary);
+        bytes.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+    }
+    writeTextFile("rejected_short.bin", bytes.substr(0, bytes.size() - 4));
+    CHECK(!readEdgeList("rejected_short.bin", V, edges));
+}
+
+// DynamicMST after random insertions and weight changes, against a
+// from-scratch Kruskal over every edge it has seen
+void checkDynamicMST() {
+    mt19937_64 rng(10);
+    for (int instance = 0; instance < 200; instance++) {
+        int V = (int)rangeRandom(rng, 1, 30);
+        vector<FlatEdge> initial = randomEdges(rng, V, 60, 50);
+        vector<FlatEdge> known = kruskalsMSTFlat(V, initial).second;
+        DynamicMST dynamic(V, known);
+        for (int update = 0; update < 40; update++) {
+            if (known.empty() || rng() % 3 != 0) {
+                FlatEdge e = {(uint32_t)rangeRandom(rng, 0, V - 1), (uint32_t)rangeRandom(rng, 0, V - 1),
+                              (int32_t)rangeRandom(rng, 1, 50)};
+                CHECK_EQUAL(dynamic.insertEdge(e.u, e.v, e.w), (int)known.size());
+                known.push_back(e);
+            } else {
+                int id = (int)(rng() % known.size());
+                known[id].w = (int32_t)rangeRandom(rng, 1, 50);
+                CHECK(dynamic.setWeight(id, known[id].w));
+            }
+            checkForest(V, known, {dynamic.totalCost(), dynamic.treeEdges()});
+        }
+
+        long long cost = dynamic.totalCost();
+        CHECK_EQUAL(dynamic.insertEdge(-1, 0, 1), -1);
+        CHECK_EQUAL(dynamic.insertEdge(0, V, 1), -1);
+        CHECK(!dynamic.setWeight((int)known.size(), 1));
+        CHECK(!dynamic.setWeight(-1, 1));
+        CHECK(!dynamic.isTreeEdge((int)known.size()));
+        CHECK_EQUAL(dynamic.totalCost(), cost);
+    }
+}
+
+// Seeds with cycles, out-of-range endpoints and self-loops; a full-graph
+// seed keeps totalCost() the graph's MST cost while tree edges get heavier
+void checkDynamicSeeds() {
+    mt19937_64 rng(11);
+    for (int instance = 0; instance < 200; instance++) {
+        int V = (int)rangeRandom(rng, 1, 30);
+        vector<FlatEdge> graph = randomEdges(rng, V, 80, 50);
+        vector<FlatEdge> seed = graph;
+        if (instance % 20 == 0) {
+            seed.insert(seed.begin() + seed.size() / 2, {(uint32_t)V, 0, 1});
+            seed.push_back({0, (uint32_t)V + 5, 1});
+        }
+        DynamicMST dynamic(V, seed);
+        checkForest(V, graph, {dynamic.totalCost(), dynamic.treeEdges()});
+        for (int update = 0; update < 20 && !graph.empty(); update++) {
+            int id = (int)(rng() % graph.size());
+            graph[id].w += (int32_t)rangeRandom(rng, 0, 30);
+            CHECK(dynamic.setWeight(id, graph[id].w));
+            checkForest(V, graph, {dynamic.totalCost(), dynamic.treeEdges()});
+        }
+        CHECK(!dynamic.setWeight((int)graph.size(), 1));
+    }
+}
+
+int main() {
+    checkFilterKruskal();
+    checkEdgeLists();
+    checkRejectedEdgeLists();
+    checkDynamicMST();
+    checkDynamicSeeds();
+    return testResult("mst_test");
+}
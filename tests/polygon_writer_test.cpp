@@ -0,0 +1,216 @@
+// Polygon writer: polygons spanning many chunks and output buffer flushes
+// decode to the same doubles from the JSON and the binary stream, and
+// non-finite coordinates are rejected.
+
+#include <cstdlib>
+#include "polygon_writer.hpp"
+#include "instance_generators.hpp"
+#include "test_support.hpp"
+using namespace std;
+
+struct Polygons {
+    vector<double> sites;              // interleaved x, y
+    vector<vector<double>> polygons;   // interleaved x, y per polygon
+};
+
+bool operator==(const Polygons &a, const Polygons &b) {
+    return a.sites == b.sites && a.polygons == b.polygons;
+}
+
+string readFile(const string &filename) {
+    ifstream in(filename, ios::binary);
+    return string(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+}
+
+bool writePolygons(const string &filename, PolygonWriter::Format format, const Polygons &data, size_t chunk) {
+    FILE *out = fopen(filename.c_str(), "wb");
+    if (out == nullptr) {
+        return false;
+    }
+    bool ok;
+    {
+        PolygonWriter writer(out, format, chunk);
+        writer.writeSites(data.sites.data(), data.sites.size() / 2);
+        for (const auto &polygon : data.polygons) {
+            writer.beginPolygon();
+            for (size_t i = 0; i < polygon.size(); i += 2) {
+                writer.addVertex(polygon[i], polygon[i + 1]);
+            }
+            writer.endPolygon();
+        }
+        ok = writer.finish();
+    }
+    return fclose(out) == 0 && ok;
+}
+
+// Decodes a VPL1 stream; chunks counts the non-empty chunks
+bool decodeBinary(const string &bytes, Polygons &data, size_t &chunks) {
+    size_t at = 0;
+    auto take = [&](void *target, size_t length) {
+        if (bytes.size() - at < length) return false;
+        memcpy(target, bytes.data() + at, length);
+        at += length;
+        return true;
+    };
+    char magic[4];
+    uint64_t count = 0;
+    if (!take(magic, 4) || memcmp(magic, "VPL1", 4) != 0 || !take(&count, sizeof count) ||
+        count > bytes.size() / 16) {
+        return false;
+    }
+    data.sites.resize(2 * count);
+    if (!take(data.sites.data(), data.sites.size() * sizeof(double))) {
+        return false;
+    }
+    chunks = 0;
+    while (true) {
+        uint32_t header[2];
+        if (!take(header, sizeof header)) return false;
+        if (header[0] == 0) break;
+        vector<uint32_t> sizes(header[0]);
+        vector<double> xy(2 * (size_t)header[1]);
+        if (!take(sizes.data(), sizes.size() * sizeof(uint32_t)) || !take(xy.data(), xy.size() * sizeof(double))) {
+            return false;
+        }
+        size_t offset = 0;
+        for (uint32_t size : sizes) {
+            if (offset + 2 * (size_t)size > xy.size()) return false;
+            data.polygons.emplace_back(xy.begin() + offset, xy.begin() + offset + 2 * size);
+            offset += 2 * size;
+        }
+        if (offset != xy.size()) return false;
+        chunks++;
+    }
+    return at == bytes.size();
+}
+
+// Minimal reader for the JSON layout: nested arrays of numbers
+class JsonReader {
+public:
+    explicit JsonReader(const string &text) : p(text.c_str()) {}
+
+    bool expect(const char *token) {
+        skip();
+        size_t length = strlen(token);
+        if (strncmp(p, token, length) != 0) return false;
+        p += length;
+        return true;
+    }
+
+    bool peek(char c) {
+        skip();
+        return *p == c;
+    }
+
+    // [[x,y],...] appended to xy
+    bool points(vector<double> &xy) {
+        if (!expect("[")) return false;
+        if (peek(']')) return expect("]");
+        do {
+            double x, y;
+            if (!expect("[") || !number(x) || !expect(",") || !number(y) || !expect("]")) return false;
+            xy.push_back(x);
+            xy.push_back(y);
+        } while (expect(","));
+        return expect("]");
+    }
+
+    bool atEnd() {
+        skip();
+        return *p == '\0';
+    }
+
+private:
+    const char *p;
+
+    void skip() {
+        while (*p == ' ' || *p == '\n') p++;
+    }
+
+    bool number(double &value) {
+        skip();
+        char *end;
+        value = strtod(p, &end);
+        if (end == p) return false;
+        p = end;
+        return true;
+    }
+};
+
+bool decodeJson(const string &text, Polygons &data) {
+    JsonReader json(text);
+    if (!json.expect("{\"sites\":") || !json.points(data.sites) || !json.expect(",\"polygons\":[")) {
+        return false;
+    }
+    if (!json.peek(']')) {
+        do {
+            data.polygons.emplace_back();
+            if (!json.points(data.polygons.back())) return false;
+        } while (json.expect(","));
+    }
+    return json.expect("]}") && json.atEnd();
+}
+
+// Random polygons, empty ones included, with awkward doubles
+Polygons randomPolygons(uint64_t seed, size_t count) {
+    mt19937_64 rng(seed);
+    Polygons data;
+    for (const SitePoint &p : randomPoints(count / 4 + 1, seed, 1e6)) {
+        data.sites.push_back(p.x);
+        data.sites.push_back(p.y);
+    }
+    uniform_real_distribution<double> coordinate(-1e6, 1e6);
+    const double special[] = {0.0, -0.0, 0.1, 1e-300, -5e-324, 1.7976931348623157e308, 123456789.0};
+    for (size_t i = 0; i < count; i++) {
+        vector<double> polygon(2 * (size_t)rangeRandom(rng, 0, 12));
+        for (double &c : polygon) {
+            c = rng() % 16 == 0 ? special[rng() % 7] : coordinate(rng);
+        }
+        data.polygons.push_back(polygon);
+    }
+    return data;
+}
+
+// Both formats decode to the written doubles, across many chunks and,
+// for the larger instance, many 1 MiB buffer flushes
+void checkRoundTrip() {
+    for (size_t count : {(size_t)0, (size_t)1, (size_t)500, (size_t)20000}) {
+        Polygons data = randomPolygons(count + 3, count);
+        for (size_t chunk : {(size_t)1, (size_t)7, (size_t)1 << 16}) {
+            CHECK(writePolygons("polygons.bin", PolygonWriter::Format::Binary, data, chunk));
+            CHECK(writePolygons("polygons.json", PolygonWriter::Format::Json, data, chunk));
+            Polygons binary, json;
+            size_t chunks = 0;
+            CHECK(decodeBinary(readFile("polygons.bin"), binary, chunks));
+            CHECK(decodeJson(readFile("polygons.json"), json));
+            CHECK(binary == data);
+            CHECK(json == data);
+            if (chunk == 7 && count >= 500) {
+                CHECK(chunks > 10);
+            }
+        }
+    }
+}
+
+// Non-finite coordinates fail finish() in both formats, and the JSON
+// stays parseable with null in their place
+void checkNonFinite() {
+    Polygons data = randomPolygons(99, 20);
+    data.polygons[10] = {1.0, 2.0, nan(""), 3.0, 4.0, HUGE_VAL};
+    CHECK(!writePolygons("polygons_nan.bin", PolygonWriter::Format::Binary, data, 7));
+    CHECK(!writePolygons("polygons_nan.json", PolygonWriter::Format::Json, data, 7));
+    string text = readFile("polygons_nan.json");
+    CHECK(text.find("[1,2],[null,3],[4,null]") != string::npos);
+    CHECK(text.find("nan") == string::npos && text.find("inf") == string::npos);
+
+    data = randomPolygons(98, 5);
+    data.sites[3] = -HUGE_VAL;
+    CHECK(!writePolygons("polygons_nan.bin", PolygonWriter::Format::Binary, data, 7));
+    CHECK(!writePolygons("polygons_nan.json", PolygonWriter::Format::Json, data, 7));
+}
+
+int main() {
+    checkRoundTrip();
+    checkNonFinite();
+    return testResult("polygon_writer_test");
+}
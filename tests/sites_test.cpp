@@ -0,0 +1,59 @@
+// Voronoi site loader: text and binary files round-trip, malformed
+// counts are rejected before anything is allocated, and non-finite
+// coordinates are rejected in both formats.
+
+#include "voronoi_sites.hpp"
+#include "instance_generators.hpp"
+#include "test_support.hpp"
+using namespace std;
+
+int main() {
+    vector<SitePoint> points = randomPoints(1000, 15, 100.0);
+    string text = to_string(points.size()) + "\n";
+    char line[64];
+    for (const SitePoint &p : points) {
+        snprintf(line, sizeof line, "%.17g %.17g\n", p.x, p.y);
+        text += line;
+    }
+    writeTextFile("sites.txt", text);
+    CHECK(writeBinarySites("sites.bin", points));
+    for (const char *filename : {"sites.txt", "sites.bin"}) {
+        vector<SitePoint> sites;
+        CHECK(readSites(filename, sites));
+        CHECK_EQUAL(sites.size(), points.size());
+        for (size_t i = 0; i < sites.size() && i < points.size(); i++) {
+            CHECK(sites[i].x == points[i].x && sites[i].y == points[i].y);
+        }
+    }
+
+    vector<SitePoint> sites;
+    writeTextFile("sites_short.txt", "3\n0 0\n1 1\n2 2");
+    CHECK(readSites("sites_short.txt", sites));
+    CHECK_EQUAL(sites.size(), (size_t)3);
+
+    const char *rejected[] = {
+        "1e300\n0 0\n",             // count far beyond the file size
+        "1e18\n0 0\n",              // still larger than the file can hold
+        "inf\n0 0\n",               // non-finite count
+        "nan\n0 0\n",               // not a number
+        "-1\n",                     // negative count
+        "2.5\n0 0\n1 1\n",          // fractional count
+        "3\n0 0\n1 1\n",            // fewer sites than declared
+        "2\n0 0\ninf 1\n",          // non-finite coordinate
+    };
+    int index = 0;
+    for (const char *contents : rejected) {
+        string filename = "sites_rejected_" + to_string(index++) + ".txt";
+        writeTextFile(filename, contents);
+        CHECK(!readSites(filename, sites));
+    }
+
+    // Binary files go through the same coordinate check
+    for (double bad : {nan(""), HUGE_VAL, -HUGE_VAL}) {
+        vector<SitePoint> corrupt = points;
+        corrupt[points.size() / 2].y = bad;
+        CHECK(writeBinarySites("sites_rejected.bin", corrupt));
+        CHECK(!readSites("sites_rejected.bin", sites));
+    }
+    return testResult("sites_test");
+}
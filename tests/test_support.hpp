@@ -0,0 +1,59 @@
+/*
+    Test support
+    Description:
+    Minimal checking helpers shared by the ctest executables. CHECK and
+    CHECK_EQUAL report a failure with its location and keep going, so
+    one run lists every disagreement; testResult() turns the failure
+    count into the exit code ctest looks at.
+*/
+
+#ifndef TEST_SUPPORT_HPP
+#define TEST_SUPPORT_HPP
+
+#include <iostream>
+#include <fstream>
+#include <string>
+
+inline int &testFailures() {
+    static int failures = 0;
+    return failures;
+}
+
+#define CHECK(condition)                                                                    \
+    do {                                                                                    \
+        if (!(condition)) {                                                                 \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: " #condition "\n"; \
+            ++testFailures();                                                               \
+        }                                                                                   \
+    } while (0)
+
+#define CHECK_EQUAL(actual, expected)                                                      \
+    do {                                                                                   \
+        auto actualValue = (actual);                                                       \
+        auto expectedValue = (expected);                                                   \
+        if (!(actualValue == expectedValue)) {                                             \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": " #actual " is " << actualValue \
+                      << ", expected " << expectedValue << "\n";                           \
+            ++testFailures();                                                              \
+        }                                                                                  \
+    } while (0)
+
+// Function: writeTextFile
+// Writes an input file for a loader test into the working directory
+inline void writeTextFile(const std::string &filename, const std::string &contents) {
+    std::ofstream out(filename, std::ios::binary);
+    out << contents;
+}
+
+// Function: testResult
+// Prints a summary and returns the process exit code
+inline int testResult(const char *name) {
+    if (testFailures() == 0) {
+        std::cout << name << ": all checks passed\n";
+        return 0;
+    }
+    std::cout << name << ": " << testFailures() << " check(s) failed\n";
+    return 1;
+}
+
+#endif
@@ -0,0 +1,222 @@
+// Cross-checks for the TSP heuristics on seeded random instances: the
+// parallel repetitive nearest neighbor against the sequential loop, the
+// local search against the tours it starts from, and Held-Karp against
+// brute force.
+
+#include <sstream>
+#include "tspNearestNeighbor.hpp"
+#include "tsp_local_search.hpp"
+#include "tsp_held_karp.hpp"
+#include "instance_generators.hpp"
+#include "test_support.hpp"
+using namespace std;
+
+// Random matrix; small weight ranges produce many ties
+template <class T>
+DistanceMatrix<T> randomMatrix(mt19937_64 &rng, int n, int maxWeight, bool symmetric) {
+    DistanceMatrix<T> graph(n);
+    for (int i = 0; i < n; i++) {
+        for (int j = symmetric ? i + 1 : 0; j < n; j++) {
+            T w = (T)rangeRandom(rng, 1, maxWeight);
+            graph.set(i, j, w);
+            if (symmetric) {
+                graph.set(j, i, w);
+            }
+        }
+    }
+    return graph;
+}
+
+// Length of a closed tour, checking that it visits every city once
+template <class T>
+typename DistanceMatrix<T>::Length tourLength(const DistanceMatrix<T> &graph, const vector<int> &tour) {
+    const int n = graph.size();
+    CHECK_EQUAL(tour.size(), (size_t)n + 1);
+    if (tour.size() != (size_t)n + 1) {
+        return -1;
+    }
+    CHECK_EQUAL(tour.front(), tour.back());
+    vector<char> seen(n, 0);
+    typename DistanceMatrix<T>::Length length = 0;
+    for (int i = 0; i < n; i++) {
+        CHECK(tour[i] >= 0 && tour[i] < n && !seen[tour[i]]);
+        seen[tour[i]] = 1;
+        length += graph.at(tour[i], tour[i + 1]);
+    }
+    return length;
+}
+
+// Sequential repetitive nearest neighbor: every start, first best wins
+template <class T>
+pair<typename DistanceMatrix<T>::Length, vector<int>> sequentialRepetitive(const DistanceMatrix<T> &graph) {
+    auto best = tspNearestNeighbor(graph, 0);
+    for (int start = 1; start < graph.size(); start++) {
+        auto route = tspNearestNeighbor(graph, start);
+        if (route.first < best.first) {
+            best = route;
+        }
+    }
+    return best;
+}
+
+// Parallel pruned runs on 1-8 threads give the sequential route exactly
+template <class T>
+void checkRepetitiveNearestNeighbor(uint64_t seed) {
+    mt19937_64 rng(seed);
+    for (int instance = 0; instance < 150; instance++) {
+        int n = (int)rangeRandom(rng, 2, 40);
+        DistanceMatrix<T> graph = instance % 3 == 0 ? euclideanMatrix<T>(n, rng(), 1000.0)
+                                                    : randomMatrix<T>(rng, n, instance % 2 ? 3 : 1000, instance % 4 < 2);
+        auto expected = sequentialRepetitive(graph);
+        CHECK_EQUAL(tourLength(graph, expected.second), expected.first);
+        for (unsigned threads : {1u, 2u, 3u, 8u}) {
+            auto route = tspRepetitiveNearestNeighbor(graph, threads);
+            CHECK_EQUAL(route.first, expected.first);
+            CHECK(route.second == expected.second);
+        }
+    }
+}
+
+// Gain of the best 2-opt move on a closed tour (0 if none improves)
+template <class T>
+typename DistanceMatrix<T>::Length bestTwoOptGain(const DistanceMatrix<T> &graph, const vector<int> &tour) {
+    const int n = graph.size();
+    typename DistanceMatrix<T>::Length best = 0;
+    for (int i = 0; i < n; i++) {
+        for (int j = i + 2; j < n; j++) {
+            int a = tour[i], b = tour[i + 1], c = tour[j], d = tour[j + 1];
+            if (a == d) {
+                continue;
+            }
+            auto gain = (typename DistanceMatrix<T>::Length)graph.at(a, b) + graph.at(c, d) - graph.at(a, c) -
+                        graph.at(b, d);
+            best = max(best, gain);
+        }
+    }
+    return best;
+}
+
+// Local search keeps the tour valid, never makes it longer, keeps the
+// start city, and with full candidate lists ends 2-opt optimal
+template <class T>
+void checkLocalSearch(uint64_t seed) {
+    mt19937_64 rng(seed);
+    for (int instance = 0; instance < 60; instance++) {
+        int n = (int)rangeRandom(rng, 5, 60);
+        DistanceMatrix<T> graph = instance % 2 ? euclideanMatrix<T>(n, rng(), 1000.0)
+                                               : randomMatrix<T>(rng, n, 1000, true);
+        auto start = tspNearestNeighbor(graph, (int)rangeRandom(rng, 0, n - 1));
+        for (int neighbors : {5, n - 1}) {
+            auto tour = tspLocalSearch(graph, start, 10.0, neighbors, 1 + instance % 4);
+            CHECK(tour.first <= start.first);
+            CHECK_EQUAL(tourLength(graph, tour.second), tour.first);
+            CHECK_EQUAL(tour.second.front(), start.second.front());
+            if (neighbors == n - 1) {
+                CHECK_EQUAL(bestTwoOptGain(graph, tour.second), (typename DistanceMatrix<T>::Length)0);
+            }
+        }
+    }
+}
+
+// Shortest closed tour from city 0 over all permutations
+template <class T>
+typename DistanceMatrix<T>::Length bruteForceTour(const DistanceMatrix<T> &graph) {
+    typedef typename DistanceMatrix<T>::Length Length;
+    vector<int> order;
+    for (int c = 1; c < graph.size(); c++) {
+        order.push_back(c);
+    }
+    Length best = -1;
+    do {
+        Length length = 0;
+        int from = 0;
+        bool complete = true;
+        for (int c : order) {
+            complete = complete && graph.at(from, c) != DistanceMatrix<T>::none();
+            length += graph.at(from, c);
+            from = c;
+        }
+        complete = complete && (from == 0 || graph.at(from, 0) != DistanceMatrix<T>::none());
+        if (complete) {
+            length += from == 0 ? 0 : graph.at(from, 0);
+            if (best < 0 || length < best) {
+                best = length;
+            }
+        }
+    } while (next_permutation(order.begin(), order.end()));
+    return best;
+}
+
+// Held-Karp on 1-4 threads against brute force, including asymmetric
+// matrices and missing edges
+template <class T>
+void checkHeldKarp(uint64_t seed) {
+    mt19937_64 rng(seed);
+    for (int instance = 0; instance < 120; instance++) {
+        int n = (int)rangeRandom(rng, 2, 9);
+        DistanceMatrix<T> graph = randomMatrix<T>(rng, n, 100, instance % 2 == 0);
+        if (instance % 3 == 0) {
+            for (int k = 0; k < n; k++) {
+                int i = (int)rangeRandom(rng, 0, n - 1), j = (int)rangeRandom(rng, 0, n - 1);
+                graph.set(i, j, 0);   // missing edge
+            }
+        }
+        auto expected = bruteForceTour(graph);
+        auto exact = tspHeldKarp(graph, 1 + instance % 4);
+        CHECK_EQUAL(exact.first, expected);
+        if (expected >= 0) {
+            CHECK_EQUAL(tourLength(graph, exact.second), expected);
+            CHECK_EQUAL(tspSolve(graph).first, expected);
+        }
+    }
+}
+
+// tspSolve only runs Held-Karp within its city limit, time budget and
+// memory cap
+void checkExactSelection() {
+    CHECK(heldKarpSeconds(heldKarpAutoCities, 1) < 1.0);
+    CHECK(heldKarpBytes<int32_t>(heldKarpAutoCities) < heldKarpMemoryCap);
+    CHECK(heldKarpBytes<int32_t>(heldKarpMaxCities) > heldKarpMemoryCap);
+    CHECK(heldKarpSeconds(heldKarpMaxCities, 1) > 10.0);
+    CHECK(heldKarpSeconds(heldKarpMaxCities, 4) < heldKarpSeconds(heldKarpMaxCities, 1));
+
+    // 25 cities with a small budget: the heuristic path answers at once
+    DistanceMatrix<int32_t> graph = euclideanMatrix<int32_t>(heldKarpMaxCities, 14, 1000.0);
+    auto started = chrono::steady_clock::now();
+    auto tour = tspSolve(graph, 0.05, 1, heldKarpMaxCities, SIZE_MAX);
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+    CHECK(seconds < 2.0);
+    CHECK_EQUAL(tourLength(graph, tour.second), tour.first);
+}
+
+// Distances the element type cannot hold are rejected before the cast
+void checkMatrixReader() {
+    DistanceMatrix<int16_t> small;
+    istringstream valid("2\n0 32766\n0 0\n");
+    CHECK(readDistanceMatrix(valid, small));
+    CHECK_EQUAL(small.at(0, 1), (int16_t)32766);
+    CHECK_EQUAL(small.at(1, 0), DistanceMatrix<int16_t>::none());
+    for (const char *text : {"2\n0 32767\n1 0\n", "2\n0 98304\n1 0\n", "2\n0 -5\n1 0\n", "2\n0 -65535\n1 0\n"}) {
+        istringstream in(text);
+        CHECK(!readDistanceMatrix(in, small));
+    }
+    DistanceMatrix<float> real;
+    istringstream negative("2\n0 -0.5\n1 0\n");
+    CHECK(!readDistanceMatrix(negative, real));
+    istringstream huge("2\n0 1e300\n1 0\n");
+    CHECK(!readDistanceMatrix(huge, real));
+}
+
+int main() {
+    checkRepetitiveNearestNeighbor<int16_t>(11);
+    checkRepetitiveNearestNeighbor<int32_t>(12);
+    checkRepetitiveNearestNeighbor<float>(13);
+    checkLocalSearch<int16_t>(21);
+    checkLocalSearch<int32_t>(22);
+    checkHeldKarp<int16_t>(31);
+    checkHeldKarp<int32_t>(32);
+    checkHeldKarp<float>(33);
+    checkExactSelection();
+    checkMatrixReader();
+    return testResult("tsp_test");
+}
@@ -0,0 +1,136 @@
+// Voronoi library (built only with CGAL): nearest-site queries against
+// brute force on 1 and several threads, and tiled cells on several grids
+// against the single-triangulation run.
+
+#include "voronoi.hpp"
+#include "instance_generators.hpp"
+#include "test_support.hpp"
+using namespace std;
+
+double squaredDistance(const SitePoint &a, const SitePoint &b) {
+    return (a.x - b.x) * (a.x - b.x) + (a.y - b.y) * (a.y - b.y);
+}
+
+// Every answer is at the brute-force nearest distance (ties may pick
+// any of the nearest sites)
+void checkLocatorOn(const vector<SitePoint> &sites, const vector<SitePoint> &queries) {
+    DelaunayTriangulation triangulation;
+    buildTriangulation(toPoints(sites), triangulation);
+    NearestSiteLocator locator(triangulation);
+    vector<Point2> points = toPoints(queries);
+    for (unsigned threads : {1u, 4u}) {
+        vector<unsigned> assigned;
+        locator.locate(points, assigned, threads);
+        CHECK_EQUAL(assigned.size(), queries.size());
+        for (size_t q = 0; q < queries.size() && q < assigned.size(); q++) {
+            double best = squaredDistance(queries[q], sites[0]);
+            for (const SitePoint &site : sites) {
+                best = min(best, squaredDistance(queries[q], site));
+            }
+            CHECK(assigned[q] < sites.size() && squaredDistance(queries[q], sites[assigned[q]]) == best);
+        }
+    }
+}
+
+// Random, clustered and lattice sites (many ties), collinear sites and
+// a single site; enough queries for several workers per batch
+void checkLocator() {
+    vector<SitePoint> queries = randomPoints(40000, 5, 1200.0);
+    for (SitePoint &q : queries) {
+        q.x -= 100;
+        q.y -= 100;
+    }
+    checkLocatorOn(randomPoints(2000, 1, 1000.0), queries);
+    checkLocatorOn(clusteredPoints(2000, 6, 2, 1000.0), queries);
+    vector<SitePoint> lattice;
+    for (int i = 0; i < 40; i++) {
+        for (int j = 0; j < 40; j++) {
+            lattice.push_back({25.0 * i, 25.0 * j});
+        }
+    }
+    vector<SitePoint> latticeQueries;
+    for (int i = 0; i < 40000; i++) {
+        latticeQueries.push_back({12.5 * (i % 200), 12.5 * (i / 200)});   // on cell edges and corners
+    }
+    checkLocatorOn(lattice, latticeQueries);
+    vector<SitePoint> line;
+    for (int i = 0; i < 300; i++) {
+        line.push_back({3.0 * i, 2.0 * i});
+    }
+    checkLocatorOn(line, queries);
+    checkLocatorOn({{500, 500}}, queries);
+}
+
+// Sites followed by the four frame corners, as the tools pass them
+vector<SitePoint> framed(vector<SitePoint> sites) {
+    for (const auto &corner : boundingSites(siteBounds(sites))) {
+        sites.push_back(corner);
+    }
+    return sites;
+}
+
+// Shoelace area of cell c, whose vertices start at xy
+double cellArea(const double *xy, uint32_t size) {
+    double area = 0;
+    for (uint32_t v = 0; v < size; v++) {
+        uint32_t w = (v + 1) % size;
+        area += xy[2 * v] * xy[2 * w + 1] - xy[2 * w] * xy[2 * v + 1];
+    }
+    return area / 2;
+}
+
+// Sites in general position: every grid gives the grid = 1 cells exactly
+void checkTilingExact(const vector<SitePoint> &sites, size_t bounded) {
+    vector<Point2> points = toPoints(sites);
+    CellList single = tiledVoronoiCells(points, 1, 1);
+    CHECK_EQUAL(single.sites.size(), bounded);
+    for (int grid : {2, 3, 5}) {
+        for (unsigned threads : {1u, 4u}) {
+            CellList tiled = tiledVoronoiCells(points, grid, threads);
+            CHECK(tiled.sites == single.sites);
+            CHECK(tiled.sizes == single.sizes);
+            CHECK(tiled.xy == single.xy);
+        }
+    }
+}
+
+// Cocircular lattice sites: the same cells with the same areas, though
+// the vertex lists may differ in near-duplicate vertices
+void checkTilingLattice() {
+    vector<SitePoint> lattice;
+    for (int i = 0; i < 30; i++) {
+        for (int j = 0; j < 30; j++) {
+            lattice.push_back({10.0 * i, 10.0 * j});
+        }
+    }
+    vector<Point2> points = toPoints(framed(lattice));
+    CellList single = tiledVoronoiCells(points, 1, 1);
+    CHECK_EQUAL(single.sites.size(), lattice.size());
+    for (int grid : {2, 3, 5}) {
+        CellList tiled = tiledVoronoiCells(points, grid, 4);
+        CHECK(tiled.sites == single.sites);
+        const double *a = single.xy.data(), *b = tiled.xy.data();
+        for (size_t c = 0; c < single.sites.size() && c < tiled.sites.size(); c++) {
+            CHECK(fabs(cellArea(a, single.sizes[c]) - cellArea(b, tiled.sizes[c])) < 1e-6);
+            a += 2 * single.sizes[c];
+            b += 2 * tiled.sizes[c];
+        }
+    }
+}
+
+void checkTiling() {
+    for (uint64_t seed = 1; seed <= 3; seed++) {
+        vector<SitePoint> sites = randomPoints(3000, seed, 1000.0);
+        checkTilingExact(framed(sites), sites.size());
+        checkTilingExact(framed(clusteredPoints(3000, 5, seed, 1000.0)), 3000);
+    }
+    // Without a frame, the hull sites have no bounded cell
+    checkTilingExact(randomPoints(3000, 9, 1.0), tiledVoronoiCells(toPoints(randomPoints(3000, 9, 1.0)), 1).sites.size());
+    checkTilingLattice();
+}
+
+int main() {
+    checkLocator();
+    checkTiling();
+    return testResult("voronoi_test");
+}
@@ -0,0 +1,140 @@
+/*
+    Thread Pool
+    Description:
+    Fixed set of worker threads shared by the parallel solvers.
+    parallelFor() splits an index range into chunks that the workers
+    claim from a shared atomic cursor, so uneven chunks balance out.
+    The calling thread takes part as worker 0, so a pool of size 1
+    runs everything inline without spawning threads.
+*/
+
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool {
+public:
+    // Constructor: ThreadPool
+    // Parameters:
+    // - threads, total workers including the caller (0 = hardware threads)
+    explicit ThreadPool(unsigned threads = 0) {
+        if (threads == 0) {
+            threads = std::thread::hardware_concurrency();
+        }
+        workerCount = threads == 0 ? 1 : threads;
+        for (unsigned i = 1; i < workerCount; ++i) {
+            workers.emplace_back([this, i] { workerLoop(i); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    unsigned size() const { return workerCount; }
+
+    // Function: run
+    // Calls task(worker) once on every worker and waits for all of them
+    // Parameters:
+    // - task, callable taking the worker index in [0, size())
+    void run(const std::function<void(unsigned)>& task) {
+        if (workerCount == 1) {
+            task(0);
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            job = &task;
+            pending = workerCount - 1;
+            ++generation;
+        }
+        wake.notify_all();
+        task(0);
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [this] { return pending == 0; });
+        job = nullptr;
+    }
+
+    // Function: parallelFor
+    // Runs body(worker, begin, end) over [0, count) in chunks of grain
+    // Parameters:
+    // - count, size of the index range
+    // - grain, indices claimed per chunk
+    // - body, callable (unsigned worker, size_t begin, size_t end)
+    template <class Body>
+    void parallelFor(size_t count, size_t grain, Body body) {
+        if (count == 0) {
+            return;
+        }
+        if (grain == 0) {
+            grain = 1;
+        }
+        if (workerCount == 1 || count <= grain) {
+            body(0u, size_t(0), count);
+            return;
+        }
+        std::atomic<size_t> cursor(0);
+        run([&](unsigned worker) {
+            while (true) {
+                size_t begin = cursor.fetch_add(grain, std::memory_order_relaxed);
+                if (begin >= count) {
+                    break;
+                }
+                size_t end = begin + grain < count ? begin + grain : count;
+                body(worker, begin, end);
+            }
+        });
+    }
+
+private:
+    unsigned workerCount = 1;
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    const std::function<void(unsigned)>* job = nullptr;
+    unsigned pending = 0;
+    unsigned long long generation = 0;
+    bool stopping = false;
+
+    void workerLoop(unsigned index) {
+        unsigned long long seen = 0;
+        while (true) {
+            const std::function<void(unsigned)>* task;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [&] { return stopping || generation != seen; });
+                if (stopping) {
+                    return;
+                }
+                seen = generation;
+                task = job;
+            }
+            (*task)(index);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (--pending == 0) {
+                    done.notify_one();
+                }
+            }
+        }
+    }
+};
+
+#endif
@@ -4,8 +4,10 @@
     This file implements two functions:
     tspNearestNeighbor() — Runs the Nearest Neighbor heuristic
     from a specific starting city.
-    tspRepetitiveNearestNeighbor() — Runs tspNearestNeighbor()
-    from every city and selects the best (shortest) route.
+    tspRepetitiveNearestNeighbor() — Runs the same heuristic
+    from every city in parallel and returns the best (shortest) route.
+    Both work on a DistanceMatrix; the vector<vector<int>> overloads
+    convert their input to one first.
 */
 
 #ifndef TSP_NEAREST_NEIGHBOR_HPP
@@ -13,86 +15,217 @@
 
 #include <iostream>
 #include <vector>
+#include <climits>
+#include <atomic>
+#include <cstdint>
+#include "thread_pool.hpp"
+#include "distance_matrix.hpp"
+#include "instrumentation.hpp"
 using namespace std;
 
 /*
-    Function: tspNearestNeighbor
+    Function: toDistanceMatrix
     Description:
-    Runs the Nearest Neighbor algorithm starting from a specific city.
+    Copies a nested adjacency matrix into a flat int32 DistanceMatrix.
+*/
+inline DistanceMatrix<int32_t> toDistanceMatrix(int n, const vector<vector<int>> &graph) {
+    DistanceMatrix<int32_t> matrix(n);
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            matrix.set(i, j, graph[i][j]);
+        }
+    }
+    return matrix;
+}
+
+/*
+    Function: nearestNeighborTour
+    Description:
+    Nearest Neighbor kernel on caller-owned scratch buffers, so repeated
+    runs allocate nothing. Each step is one argminMasked call over the
+    current row: visited cities are masked with the sentinel instead of
+    being tested in a branch. Stops early once the partial distance
+    exceeds bound, since the tour can no longer beat the best one known.
 
     Parameters:
-    n: number of cities
+    graph: distance matrix
     start: index of the starting city (0-based)
-    graph: adjacency matrix with distances between cities
+    mask: scratch of size n, overwritten (0 = unvisited)
+    rowScratch: scratch for gathering triangular rows
+    path: receives the route order
+    bound: abandon the tour when its distance grows past this value
 
     Return value:
-    A pair containing:
-     Total distance of the route
-     Vector with the route order
+    Total distance of the route, or -1 if it was abandoned
 */
-pair<int, vector<int>> tspNearestNeighbor(int n, int start, const vector<vector<int>> &graph) {
-    vector<bool> visited(n, false);  
-    vector<int> path;                
-    int current = start;             
-    int totalDistance = 0;           
+template <class T>
+typename DistanceMatrix<T>::Length nearestNeighborTour(const DistanceMatrix<T> &graph, int start, vector<T> &mask,
+                                                       vector<T> &rowScratch, vector<int> &path,
+                                                       typename DistanceMatrix<T>::Length bound) {
+    typedef typename DistanceMatrix<T>::Length Length;
+    const int n = graph.size();
+    const T none = DistanceMatrix<T>::none();
+    mask.assign(n, T(0));
+    path.clear();
+    int current = start;
+    Length totalDistance = 0;
 
     path.push_back(current);
-    visited[current] = true;
+    mask[current] = none;
+    INSTRUMENT_ADD(TspTours, 1);
+    int scans = 0;
 
     for (int i = 1; i < n; i++) {
-        int nearest = -1;
-        int minDistance = INT_MAX;
+        const T *row = graph.row(current, rowScratch);
+        int nearest = argminMasked(row, mask.data(), n);
+        scans++;
 
-        for (int j = 0; j < n; j++) {
-            if (!visited[j] && graph[current][j] > 0 && graph[current][j] < minDistance) {
-                minDistance = graph[current][j];
-                nearest = j;
-            }
+        // Nothing reachable: later steps would find nothing either
+        if (nearest == -1) {
+            break;
         }
-
-        if (nearest != -1) {
-            visited[nearest] = true;
-            path.push_back(nearest);
-            totalDistance += minDistance;
-            current = nearest;
+        mask[nearest] = none;
+        path.push_back(nearest);
+        totalDistance += row[nearest];
+        current = nearest;
+        if (totalDistance > bound) {
+            break;
         }
     }
+    INSTRUMENT_ADD(TspCandidateScans, scans);
+    INSTRUMENT_ADD(TspCandidatesScanned, (uint64_t)scans * n);
+    if (totalDistance > bound) {
+        INSTRUMENT_ADD(TspToursPruned, 1);
+        return -1;
+    }
 
-    if (graph[current][start] > 0) {
-        totalDistance += graph[current][start];
+    if (graph.at(current, start) != none) {
+        totalDistance += graph.at(current, start);
     }
     path.push_back(start);
+    if (totalDistance > bound) {
+        INSTRUMENT_ADD(TspToursPruned, 1);
+        return -1;
+    }
+    return totalDistance;
+}
+
+/*
+    Function: tspNearestNeighbor
+    Description:
+    Runs the Nearest Neighbor algorithm starting from a specific city.
+
+    Parameters:
+    graph: distance matrix
+    start: index of the starting city (0-based)
+
+    Return value:
+    A pair containing:
+     Total distance of the route
+     Vector with the route order
+*/
+template <class T>
+pair<typename DistanceMatrix<T>::Length, vector<int>> tspNearestNeighbor(const DistanceMatrix<T> &graph, int start) {
+    vector<T> mask, rowScratch;
+    vector<int> path;
+    auto totalDistance = nearestNeighborTour(graph, start, mask, rowScratch, path,
+                                             numeric_limits<typename DistanceMatrix<T>::Length>::max());
 
     // Return both total distance and path
     return {totalDistance, path};
 }
 
+inline pair<int, vector<int>> tspNearestNeighbor(int n, int start, const vector<vector<int>> &graph) {
+    auto route = tspNearestNeighbor(toDistanceMatrix(n, graph), start);
+    return {(int)route.first, route.second};
+}
+
 /*
     Function: tspRepetitiveNearestNeighbor
     Description:
     Executes the Nearest Neighbor heuristic starting from every city
     and selects the route with the smallest total distance.
+    Start cities are handed out one at a time from a shared counter on a
+    thread pool, so idle workers keep taking the remaining starts. Each
+    worker reuses its own mask/path buffers. The best complete distance
+    so far is shared through an atomic; a tour is dropped as soon as its
+    partial distance exceeds it. Ties go to the lowest start city, so
+    the answer matches the sequential loop.
 
     Parameters:
-    n: number of neighborhoods
-    graph: adjacency matrix with distances between neighborhoods
+    graph: distance matrix
+    threads: worker count (0 = hardware threads)
 
     Return value:
-    None — it prints the best route and total distance.
+    A pair containing the best total distance and its route
 */
-void tspRepetitiveNearestNeighbor(int n, const vector<vector<int>> &graph) {
-    int bestDistance = INT_MAX;
-    vector<int> bestPath;
-
-    for (int start = 0; start < n; start++) {
-        pair<int, vector<int>> result = tspNearestNeighbor(n, start, graph);
+template <class T>
+pair<typename DistanceMatrix<T>::Length, vector<int>> tspRepetitiveNearestNeighbor(const DistanceMatrix<T> &graph,
+                                                                                   unsigned threads = 0) {
+    typedef typename DistanceMatrix<T>::Length Length;
+    const int n = graph.size();
+    if (n <= 0) {
+        return {0, {}};
+    }
+    ThreadPool pool(threads);
+    atomic<Length> best(numeric_limits<Length>::max());
+
+    struct Scratch {
+        vector<T> mask, row;
+        vector<int> path;
+        vector<int> bestPath;
+        Length bestDistance = numeric_limits<Length>::max();
+        int bestStart = INT_MAX;
+    };
+    vector<Scratch> scratch(pool.size());
+
+    pool.parallelFor(n, 1, [&](unsigned worker, size_t begin, size_t end) {
+        Scratch &s = scratch[worker];
+        for (size_t start = begin; start < end; start++) {
+            Length seen = best.load(memory_order_relaxed);
+            Length distance = nearestNeighborTour(graph, (int)start, s.mask, s.row, s.path, seen);
+            if (distance < 0) {
+                continue;
+            }
+            while (distance < seen && !best.compare_exchange_weak(seen, distance, memory_order_relaxed)) {
+            }
+            if (distance < s.bestDistance || (distance == s.bestDistance && (int)start < s.bestStart)) {
+                s.bestDistance = distance;
+                s.bestStart = (int)start;
+                s.bestPath.swap(s.path);
+            }
+        }
+    });
 
-        if (result.first < bestDistance) {
-            bestDistance = result.first;
-            bestPath = result.second;
+    Scratch *winner = &scratch[0];
+    for (auto &s : scratch) {
+        if (s.bestDistance < winner->bestDistance ||
+            (s.bestDistance == winner->bestDistance && s.bestStart < winner->bestStart)) {
+            winner = &s;
         }
     }
+    return {winner->bestDistance, winner->bestPath};
+}
+
+inline pair<int, vector<int>> tspRepetitiveNearestNeighbor(int n, const vector<vector<int>> &graph, unsigned threads = 0) {
+    auto route = tspRepetitiveNearestNeighbor(toDistanceMatrix(n, graph), threads);
+    return {(int)route.first, route.second};
+}
+
+/*
+    Function: printTSPRoute
+    Description:
+    Prints a route as letters (A = city 0) and its total distance.
+
+    Parameters:
+    route: pair of total distance and route order
 
+    Return value:
+    None
+*/
+template <class Length>
+void printTSPRoute(const pair<Length, vector<int>> &route) {
+    const vector<int> &bestPath = route.second;
     cout << "\n PART 2 :\n";
     for (int i = 0; i < static_cast<int>(bestPath.size()); i++) {
         cout << char('A' + bestPath[i]);
@@ -100,7 +233,7 @@ void tspRepetitiveNearestNeighbor(int n, const vector<vector<int>> &graph) {
             cout << " -> ";
         }
     }
-    cout << "\nTotal distance: " << bestDistance << " km\n";
+    cout << "\nTotal distance: " << route.first << " km\n";
 }
 
 #endif
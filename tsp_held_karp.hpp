@@ -0,0 +1,359 @@
+/*
+   Traveling Salesman Problem (TSP) - Held-Karp
+    Description:
+    Exact dynamic program for small instances (up to 25 cities).
+    cost(S, j) is the shortest path that leaves city 0, visits every
+    city of S and ends at j in S. It is computed one subset size at a
+    time. Each layer only reads the layer before it, so only two
+    layers of costs are kept. Within a layer, subsets are stored in
+    colex rank order, with the entries of one subset next to each other
+    (subset-major). The parent table keeps one byte per entry for the
+    whole run and is enough to rebuild the optimal tour.
+    At 25 cities this is about 17 s of single-core work and 850 MB.
+    tspSolve() only picks Held-Karp on its own up to 20 cities (about
+    0.5 s and 20 MB), and only when the estimated time fits the caller's
+    budget and the estimated memory fits a cap; otherwise it runs the
+    repetitive nearest neighbor plus local search.
+*/
+
+#ifndef TSP_HELD_KARP_HPP
+#define TSP_HELD_KARP_HPP
+
+#include <vector>
+#include <limits>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+#include <cmath>
+#include "thread_pool.hpp"
+#include "distance_matrix.hpp"
+#include "tspNearestNeighbor.hpp"
+#include "tsp_local_search.hpp"
+using namespace std;
+
+static const int heldKarpMaxCities = 25;
+
+// Largest n tspSolve() solves exactly by default
+static const int heldKarpAutoCities = 20;
+
+// Memory tspSolve() allows Held-Karp by default
+static const size_t heldKarpMemoryCap = (size_t)256 << 20;
+
+// Conservative single-core DP speed, used to estimate run times
+static const double heldKarpTransitionsPerSecond = 1e8;
+
+// Subset bitmask type: one bit per city other than city 0
+template <bool Narrow> struct HeldKarpMask { typedef uint32_t Type; };
+template <> struct HeldKarpMask<true> { typedef uint16_t Type; };
+
+// DP cost type: wide enough for a 25-edge path of the element type
+template <class T> struct HeldKarpCost;
+template <> struct HeldKarpCost<int16_t> { typedef int32_t Type; };
+template <> struct HeldKarpCost<int32_t> { typedef int64_t Type; };
+template <> struct HeldKarpCost<float> { typedef double Type; };
+
+/*
+    Class: HeldKarp
+    Description:
+    Solver for at most MaxN cities. MaxN fixes the mask width and the
+    size of the per-subset stack arrays.
+*/
+template <int MaxN, class T>
+class HeldKarp {
+    static_assert(MaxN >= 2 && MaxN <= heldKarpMaxCities, "HeldKarp supports 2 to 25 cities");
+    typedef typename HeldKarpMask<MaxN <= 17>::Type Mask;
+    typedef typename HeldKarpCost<T>::Type Cost;
+    typedef typename DistanceMatrix<T>::Length Length;
+
+public:
+    /*
+        Function: solve
+        Description:
+        Computes an optimal tour starting and ending at city 0.
+
+        Parameters:
+        graph: distance matrix with at most MaxN cities
+        threads: workers per layer (0 = hardware threads)
+
+        Return value:
+        A pair containing the tour length and the route, or {-1, {}} if
+        missing edges leave no tour
+
+        Time Complexity: O(2^n * n^2)
+        Space Complexity: O(2^n * n) bytes of parents, plus the two
+        largest cost layers
+    */
+    pair<Length, vector<int>> solve(const DistanceMatrix<T> &graph, unsigned threads) {
+        n = graph.size();
+        m = n - 1;
+        if (n == 1) {
+            return {0, {0, 0}};
+        }
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < n; j++) {
+                T w = graph.at(i, j);
+                dist[i][j] = w == DistanceMatrix<T>::none() ? infinity() : (Cost)w;
+            }
+        }
+        for (int a = 0; a <= m; a++) {
+            binomial[a][0] = 1;
+            for (int b = 1; b <= m; b++) {
+                binomial[a][b] = a == 0 ? 0 : binomial[a - 1][b - 1] + binomial[a - 1][b];
+            }
+        }
+
+        ThreadPool pool(threads);
+        parents.assign(m + 1, {});
+        vector<Cost> previous(m), current;
+        parents[1].assign(m, 0);
+        for (int b = 0; b < m; b++) {
+            previous[b] = dist[0][b + 1];
+        }
+
+        for (int k = 2; k <= m; k++) {
+            size_t subsets = binomial[m][k];
+            current.assign(subsets * k, infinity());
+            parents[k].assign(subsets * k, 0);
+            pool.parallelFor(subsets, 512, [&](unsigned, size_t begin, size_t end) {
+                Mask set = unrank(begin, k);
+                for (size_t r = begin; r < end; r++) {
+                    extend(set, r, k, previous, current);
+                    set = nextSubset(set);
+                }
+            });
+            previous.swap(current);
+        }
+
+        // Close the tour back to city 0
+        Cost best = infinity();
+        int last = -1;
+        for (int p = 0; p < m; p++) {
+            if (previous[p] == infinity() || dist[p + 1][0] == infinity()) {
+                continue;
+            }
+            Cost total = previous[p] + dist[p + 1][0];
+            if (total < best) {
+                best = total;
+                last = p;
+            }
+        }
+        if (last < 0) {
+            return {-1, {}};
+        }
+
+        vector<int> path(n + 1, 0);
+        Mask set = (Mask)((1u << m) - 1);
+        int bit = last;
+        for (int k = m; k >= 1; k--) {
+            path[k] = bit + 1;
+            int parent = parents[k][rank(set) * k + position(set, bit)];
+            set = (Mask)(set & ~(1u << bit));
+            bit = parent - 1;
+        }
+        return {(Length)best, path};
+    }
+
+private:
+    int n = 0, m = 0;
+    Cost dist[MaxN][MaxN];
+    uint32_t binomial[MaxN][MaxN];
+    vector<vector<uint8_t>> parents;   // layer k: subset rank * k + position -> previous city
+
+    static Cost infinity() { return numeric_limits<Cost>::max(); }
+
+    // Colex rank among subsets of the same size; equals numeric order
+    size_t rank(Mask set) const {
+        size_t r = 0;
+        for (int t = 1; set; t++) {
+            int b = lowestSetBit(set);
+            r += binomial[b][t];
+            set = (Mask)(set & (set - 1));
+        }
+        return r;
+    }
+
+    Mask unrank(size_t r, int k) const {
+        Mask set = 0;
+        int b = m - 1;
+        for (int t = k; t >= 1; t--) {
+            while (binomial[b][t] > r) {
+                b--;
+            }
+            r -= binomial[b][t];
+            set = (Mask)(set | (1u << b));
+            b--;
+        }
+        return set;
+    }
+
+    // Next subset of the same size in numeric order (Gosper's hack)
+    static Mask nextSubset(Mask set) {
+        uint32_t x = set;
+        uint32_t low = x & (0u - x);
+        uint32_t ripple = x + low;
+        return (Mask)((((ripple ^ x) >> 2) / low) | ripple);
+    }
+
+    static int position(Mask set, int bit) {
+        int p = 0;
+        for (Mask below = (Mask)(set & ((1u << bit) - 1)); below; below = (Mask)(below & (below - 1))) {
+            p++;
+        }
+        return p;
+    }
+
+    /*
+        Fills cost(S, j) for every j in S, where S has rank r in layer k.
+        For the subset S - j, bits before j keep their index t in the rank
+        sum and bits after j move down by one, so its rank comes from
+        prefix and suffix sums instead of a rescan.
+    */
+    void extend(Mask set, size_t r, int k, const vector<Cost> &previous, vector<Cost> &current) {
+        int bits[MaxN];
+        size_t keep[MaxN + 1], shift[MaxN + 1];
+        int count = 0;
+        for (Mask s = set; s; s = (Mask)(s & (s - 1))) {
+            bits[count++] = lowestSetBit(s);
+        }
+        keep[0] = 0;
+        for (int t = 0; t < k; t++) {
+            keep[t + 1] = keep[t] + binomial[bits[t]][t + 1];
+        }
+        shift[k] = 0;
+        for (int t = k - 1; t >= 0; t--) {
+            shift[t] = shift[t + 1] + binomial[bits[t]][t];
+        }
+
+        Cost *out = &current[r * k];
+        uint8_t *from = &parents[k][r * k];
+        for (int p = 0; p < k; p++) {
+            int j = bits[p] + 1;
+            size_t sub = keep[p] + shift[p + 1];
+            const Cost *in = &previous[sub * (k - 1)];
+            Cost best = infinity();
+            int arg = 0;
+            for (int q = 0; q < k; q++) {
+                if (q == p) {
+                    continue;
+                }
+                Cost before = in[q < p ? q : q - 1];
+                Cost w = dist[bits[q] + 1][j];
+                if (before == infinity() || w == infinity()) {
+                    continue;
+                }
+                if (before + w < best) {
+                    best = before + w;
+                    arg = bits[q] + 1;
+                }
+            }
+            out[p] = best;
+            from[p] = (uint8_t)arg;
+        }
+    }
+};
+
+/*
+    Function: tspHeldKarp
+    Description:
+    Exact tour for at most heldKarpMaxCities cities. Picks the narrowest
+    solver instantiation that fits n.
+
+    Parameters:
+    graph: distance matrix (may be asymmetric)
+    threads: workers per layer (0 = hardware threads)
+
+    Return value:
+    A pair containing the optimal tour length and its route from city 0,
+    or {-1, {}} if there is no tour or n is too large
+*/
+template <class T>
+pair<typename DistanceMatrix<T>::Length, vector<int>> tspHeldKarp(const DistanceMatrix<T> &graph, unsigned threads = 0) {
+    int n = graph.size();
+    if (n <= 0) {
+        return {0, {}};
+    }
+    if (n > heldKarpMaxCities) {
+        cerr << "Error: Held-Karp supports at most " << heldKarpMaxCities << " cities\n";
+        return {-1, {}};
+    }
+    if (n <= 8) {
+        return HeldKarp<8, T>().solve(graph, threads);
+    }
+    if (n <= 17) {
+        return HeldKarp<17, T>().solve(graph, threads);
+    }
+    return HeldKarp<heldKarpMaxCities, T>().solve(graph, threads);
+}
+
+/*
+    Function: heldKarpBytes
+    Description:
+    Memory of a Held-Karp run on n cities: one parent byte per DP entry,
+    m * 2^(m-1) entries with m = n - 1, plus the two largest cost layers.
+*/
+template <class T>
+size_t heldKarpBytes(int n) {
+    if (n <= 2) {
+        return 0;
+    }
+    int m = n - 1;
+    size_t binomial = 1;    // C(m, k)
+    size_t widest = 0;      // largest layer, C(m, k) * k entries
+    for (int k = 1; k <= m; k++) {
+        binomial = binomial * (m - k + 1) / k;
+        widest = max(widest, binomial * k);
+    }
+    return ((size_t)m << (m - 1)) + 2 * widest * sizeof(typename HeldKarpCost<T>::Type);
+}
+
+/*
+    Function: heldKarpSeconds
+    Description:
+    Estimated wall time of a Held-Karp run on n cities: about
+    m * (m - 1) * 2^(m-2) transitions at heldKarpTransitionsPerSecond per
+    worker, with m = n - 1.
+*/
+inline double heldKarpSeconds(int n, unsigned threads) {
+    if (n <= 2) {
+        return 0.0;
+    }
+    unsigned workers = threads ? threads : max(1u, thread::hardware_concurrency());
+    double m = n - 1;
+    return m * (m - 1) * ldexp(1.0, n - 3) / (heldKarpTransitionsPerSecond * workers);
+}
+
+/*
+    Function: tspSolve
+    Description:
+    Exact Held-Karp up to exactLimit cities when its estimated time fits
+    in seconds and its estimated memory fits in memoryCap. Otherwise, or
+    when missing edges leave no exact tour, repetitive nearest neighbor
+    refined by 2-opt/Or-opt within the time budget.
+
+    Parameters:
+    graph: distance matrix
+    seconds: time budget for the exact solve or the local search
+    threads: worker count (0 = hardware threads)
+    exactLimit: largest n solved exactly (at most heldKarpMaxCities)
+    memoryCap: largest Held-Karp footprint allowed, in bytes
+
+    Return value:
+    A pair containing the tour length and its route
+*/
+template <class T>
+pair<typename DistanceMatrix<T>::Length, vector<int>> tspSolve(const DistanceMatrix<T> &graph, double seconds = 1.0,
+                                                               unsigned threads = 0,
+                                                               int exactLimit = heldKarpAutoCities,
+                                                               size_t memoryCap = heldKarpMemoryCap) {
+    int n = graph.size();
+    if (n <= min(exactLimit, heldKarpMaxCities) && heldKarpBytes<T>(n) <= memoryCap &&
+        heldKarpSeconds(n, threads) <= seconds) {
+        auto exact = tspHeldKarp(graph, threads);
+        if (exact.first >= 0) {
+            return exact;
+        }
+    }
+    return tspLocalSearch(graph, tspRepetitiveNearestNeighbor(graph, threads), seconds, 8, threads);
+}
+
+#endif
@@ -0,0 +1,373 @@
+/*
+   Traveling Salesman Problem (TSP) - Local Search
+    Description:
+    Improves a closed tour (for example the one returned by
+    tspRepetitiveNearestNeighbor) with 2-opt and Or-opt moves.
+    The tour is an array with a position lookup per city. A move is
+    only tried against the k nearest neighbors of a city. Don't-look
+    bits keep the search on cities whose surroundings recently changed.
+    The search stops at a local optimum or when the wall-clock budget
+    runs out, whichever comes first.
+    Distances are assumed symmetric; 0 off the diagonal means no edge.
+*/
+
+#ifndef TSP_LOCAL_SEARCH_HPP
+#define TSP_LOCAL_SEARCH_HPP
+
+#include <vector>
+#include <deque>
+#include <chrono>
+#include <climits>
+#include <algorithm>
+#include "thread_pool.hpp"
+#include "distance_matrix.hpp"
+using namespace std;
+
+/*
+    Class: TwoOptSearch
+    Description:
+    State of one local search run: the tour array, the position of every
+    city in it, the candidate lists and the queue of active cities.
+*/
+template <class T>
+class TwoOptSearch {
+public:
+    typedef typename DistanceMatrix<T>::Length Length;
+
+    TwoOptSearch(const DistanceMatrix<T> &graph, const vector<int> &route, int neighbors, unsigned threads)
+        : n(graph.size()), graph(graph), tour(route.begin(), route.begin() + n), pos(n), active(n, 1) {
+        for (int i = 0; i < n; i++) {
+            pos[tour[i]] = i;
+        }
+        buildCandidates(neighbors, threads);
+    }
+
+    /*
+        Function: run
+        Description:
+        Applies improving moves until no active city is left or the
+        deadline passes. Don't-look bits can leave a move that only an
+        inactive city would find, so an empty queue starts one more
+        sweep over every city; the search ends after a sweep that
+        applies nothing, which is a true local optimum for the
+        candidate lists.
+
+        Return value:
+        Number of moves applied
+    */
+    long long run(chrono::steady_clock::time_point deadline) {
+        deque<int> queue;
+        long long moves = 0;
+        long long sweepStart = -1;
+        unsigned checks = 0;
+        while (true) {
+            if (queue.empty()) {
+                if (moves == sweepStart) {
+                    break;
+                }
+                sweepStart = moves;
+                for (int i = 0; i < n; i++) {
+                    active[tour[i]] = 1;
+                    queue.push_back(tour[i]);
+                }
+            }
+            if ((++checks & 255) == 0 && chrono::steady_clock::now() >= deadline) {
+                break;
+            }
+            int a = queue.front();
+            queue.pop_front();
+            active[a] = 0;
+            touched.clear();
+            if (improveTwoOpt(a) || improveOrOpt(a)) {
+                moves++;
+                touched.push_back(a);
+                for (int c : touched) {
+                    if (!active[c]) {
+                        active[c] = 1;
+                        queue.push_back(c);
+                    }
+                }
+            }
+        }
+        return moves;
+    }
+
+    /*
+        Function: route
+        Description:
+        The tour in the tspNearestNeighbor layout: it starts at start and
+        returns to it.
+    */
+    vector<int> route(int start) const {
+        vector<int> path;
+        path.reserve(n + 1);
+        for (int i = 0; i < n; i++) {
+            path.push_back(tour[(pos[start] + i) % n]);
+        }
+        path.push_back(start);
+        return path;
+    }
+
+private:
+    int n;
+    const DistanceMatrix<T> &graph;
+    vector<int> tour;          // position -> city
+    vector<int> pos;           // city -> position
+    vector<char> active;       // inverse of the don't-look bit
+    vector<vector<int>> candidates;
+    vector<int> touched;       // endpoints of the last move
+
+    // Missing edges cost more than any real one, so moves avoid them
+    Length dist(int a, int b) const {
+        T w = graph.at(a, b);
+        return w != DistanceMatrix<T>::none() ? (Length)w : (Length)INT_MAX;
+    }
+
+    int next(int c) const { return tour[pos[c] + 1 == n ? 0 : pos[c] + 1]; }
+    int prev(int c) const { return tour[pos[c] == 0 ? n - 1 : pos[c] - 1]; }
+
+    void place(int i, int c) {
+        tour[i] = c;
+        pos[c] = i;
+    }
+
+    void buildCandidates(int neighbors, unsigned threads) {
+        candidates.assign(n, {});
+        int k = min(neighbors, n - 1);
+        ThreadPool pool(threads);
+        pool.parallelFor(n, 64, [&](unsigned, size_t begin, size_t end) {
+            vector<T> scratch;
+            for (size_t a = begin; a < end; a++) {
+                vector<int> &list = candidates[a];
+                const T *row = graph.row((int)a, scratch);
+                for (int c = 0; c < n; c++) {
+                    if (row[c] != DistanceMatrix<T>::none()) {
+                        list.push_back(c);
+                    }
+                }
+                auto closer = [&](int x, int y) { return row[x] < row[y]; };
+                if ((int)list.size() > k) {
+                    nth_element(list.begin(), list.begin() + k, list.end(), closer);
+                    list.resize(k);
+                }
+                sort(list.begin(), list.end(), closer);
+            }
+        });
+    }
+
+    // Reverses the tour between positions i and j (inclusive, going
+    // forward), or the complementary part when that is shorter
+    void reverse(int i, int j) {
+        int len = (j - i + n) % n + 1;
+        if (2 * len > n) {
+            int start = (j + 1) % n;
+            j = (i - 1 + n) % n;
+            i = start;
+            len = n - len;
+        }
+        for (int k = 0; k < len / 2; k++) {
+            int x = tour[(i + k) % n];
+            int y = tour[(j - k + n) % n];
+            place((i + k) % n, y);
+            place((j - k + n) % n, x);
+        }
+    }
+
+    /*
+        Function: improveTwoOpt
+        Description:
+        Looks for edges (a, b) and (c, d), with c a candidate of a, whose
+        replacement by (a, c) and (b, d) shortens the tour. Both tour
+        directions are tried. The scan of a's candidates stops once
+        d(a, c) reaches d(a, b), since no later candidate can gain.
+
+        Return value:
+        true if a move was applied
+    */
+    bool improveTwoOpt(int a) {
+        for (int forward = 1; forward >= 0; forward--) {
+            int b = forward ? next(a) : prev(a);
+            Length ab = dist(a, b);
+            for (int c : candidates[a]) {
+                Length g = ab - dist(a, c);
+                if (g <= 0) {
+                    break;
+                }
+                int d = forward ? next(c) : prev(c);
+                if (c == b || d == a) {
+                    continue;
+                }
+                if (g + dist(c, d) - dist(b, d) > 0) {
+                    if (forward) {
+                        reverse(pos[b], pos[c]);
+                    } else {
+                        reverse(pos[a], pos[d]);
+                    }
+                    touched.insert(touched.end(), {b, c, d});
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    /*
+        Function: improveOrOpt
+        Description:
+        Moves a segment of 1 to 3 cities that starts or ends at a to sit
+        between a candidate city and one of its tour neighbors, in either
+        orientation.
+
+        Return value:
+        true if a move was applied
+    */
+    bool improveOrOpt(int a) {
+        if (n < 8) {
+            return false;
+        }
+        for (int length = 1; length <= 3; length++) {
+            for (int first : {pos[a], (pos[a] - length + 1 + n) % n}) {
+                if (tryOrOpt(first, length)) {
+                    return true;
+                }
+                if (length == 1) {
+                    break;
+                }
+            }
+        }
+        return false;
+    }
+
+    bool tryOrOpt(int first, int length) {
+        int s1 = tour[first];
+        int s2 = tour[(first + length - 1) % n];
+        int p = prev(s1), nx = next(s2);
+        Length removed = dist(p, s1) + dist(s2, nx) - dist(p, nx);
+        if (removed <= 0) {
+            return false;
+        }
+        auto inSegment = [&](int c) { return (pos[c] - first + n) % n < length; };
+
+        // New edges touch s1 or s2 and one of their candidates
+        for (int end = 0; end < 2; end++) {
+            int s = end ? s2 : s1;
+            for (int c : candidates[s]) {
+                if (dist(s, c) >= removed) {
+                    break;
+                }
+                if (inSegment(c)) {
+                    continue;
+                }
+                // Insert between (x, y) = (c, next c) or (prev c, c)
+                for (int after = 1; after >= 0; after--) {
+                    int x = after ? c : prev(c);
+                    int y = after ? next(c) : c;
+                    if (inSegment(x) || inSegment(y) || x == p) {
+                        continue;
+                    }
+                    // s touches c: keep the segment's orientation or flip it
+                    bool reversed = s1 != s2 && (after ? s == s2 : s == s1);
+                    Length added = reversed ? dist(x, s2) + dist(s1, y) : dist(x, s1) + dist(s2, y);
+                    if (added - dist(x, y) < removed) {
+                        moveSegment(first, length, x, reversed);
+                        touched.insert(touched.end(), {s1, s2, p, nx, x, y});
+                        return true;
+                    }
+                }
+            }
+        }
+        return false;
+    }
+
+    // Moves the segment at [first, first + length) to just after city x,
+    // shifting whichever side of the tour between them is shorter
+    void moveSegment(int first, int length, int x, bool reversed) {
+        int segment[3];
+        for (int k = 0; k < length; k++) {
+            segment[k] = tour[(first + k) % n];
+        }
+        if (reversed) {
+            std::reverse(segment, segment + length);
+        }
+        int q = pos[x];
+        int after = (q - (first + length) + 2 * n) % n + 1;   // cities from next(s2) to x
+        int before = n - length - after;                      // cities from next(x) to prev(s1)
+        if (after <= before) {
+            for (int k = 0; k < after; k++) {
+                place((first + k) % n, tour[(first + length + k) % n]);
+            }
+            for (int k = 0; k < length; k++) {
+                place((first + after + k) % n, segment[k]);
+            }
+        } else {
+            for (int k = before - 1; k >= 0; k--) {
+                place((q + 1 + length + k) % n, tour[(q + 1 + k) % n]);
+            }
+            for (int k = 0; k < length; k++) {
+                place((q + 1 + k) % n, segment[k]);
+            }
+        }
+    }
+};
+
+/*
+    Function: tspLocalSearch
+    Description:
+    Refines a closed tour with candidate-list 2-opt and Or-opt.
+    Tours that do not visit every city once (a Nearest Neighbor run that
+    got stuck on missing edges) are returned unchanged.
+
+    Parameters:
+    graph: distance matrix
+    tour: pair of total distance and route, as from tspNearestNeighbor
+    seconds: wall-clock budget for the search
+    neighbors: candidate list length per city
+    threads: workers for building the candidate lists (0 = hardware threads)
+
+    Return value:
+    A pair containing the improved total distance and route, starting
+    and ending at the same city as the input
+
+    Time Complexity: O(n^2) for the candidate lists, then about O(k) per
+    move evaluation plus O(n) per applied move
+*/
+template <class T>
+pair<typename DistanceMatrix<T>::Length, vector<int>> tspLocalSearch(
+    const DistanceMatrix<T> &graph, const pair<typename DistanceMatrix<T>::Length, vector<int>> &tour,
+    double seconds = 1.0, int neighbors = 8, unsigned threads = 0) {
+    const int n = graph.size();
+    auto deadline = chrono::steady_clock::now() +
+                    chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(seconds));
+    const vector<int> &route = tour.second;
+    if (n < 5 || (int)route.size() != n + 1) {
+        return tour;
+    }
+    vector<char> seen(n, 0);
+    for (int i = 0; i < n; i++) {
+        if (route[i] < 0 || route[i] >= n || seen[route[i]]) {
+            return tour;
+        }
+        seen[route[i]] = 1;
+    }
+
+    TwoOptSearch<T> search(graph, route, neighbors, threads);
+    search.run(deadline);
+    vector<int> path = search.route(route[0]);
+
+    // Same convention as tspNearestNeighbor: missing edges add nothing
+    typename DistanceMatrix<T>::Length totalDistance = 0;
+    for (int i = 0; i < n; i++) {
+        T w = graph.at(path[i], path[i + 1]);
+        if (w != DistanceMatrix<T>::none()) {
+            totalDistance += w;
+        }
+    }
+    // A tour that swapped a missing edge for real ones can score worse
+    // under that convention; keep the input then
+    if (totalDistance > tour.first) {
+        return tour;
+    }
+    return {totalDistance, path};
+}
+
+#endif
@@ -1,33 +1,10 @@
 /* 
     Voronoi Diagram 
     Description:
-    This program constructs and displays a Voronoi diagram from a given set 
-    of 2D points using the CGAL (Computational Geometry Algorithms Library).
-    It outputs the coordinates of the sites and the vertices of each Voronoi cell.
-
+    Definitions for the Voronoi library declared in voronoi.hpp.
 */
 
-#ifndef VORONOI_DIAGRAM_HPP
-#define VORONOI_DIAGRAM_HPP
-
-#include <CGAL/Exact_predicates_inexact_constructions_kernel.h>
-#include <CGAL/Voronoi_diagram_2.h>
-#include <CGAL/Delaunay_triangulation_2.h>
-#include <CGAL/Delaunay_triangulation_adaptation_traits_2.h>
-#include <CGAL/Delaunay_triangulation_adaptation_policies_2.h>
-#include <iostream>
-#include <vector>
-using namespace std;
-
-// Type definitions for geometric kernel and structures
-typedef CGAL::Exact_predicates_inexact_constructions_kernel Kernel;
-typedef CGAL::Delaunay_triangulation_2<Kernel> DelaunayTriangulation;
-typedef CGAL::Delaunay_triangulation_adaptation_traits_2<DelaunayTriangulation> AdaptationTraits;
-typedef CGAL::Delaunay_triangulation_caching_degeneracy_removal_policy_2<DelaunayTriangulation> AdaptationPolicy;
-typedef CGAL::Voronoi_diagram_2<DelaunayTriangulation, AdaptationTraits, AdaptationPolicy> VoronoiDiagram;
-
-typedef AdaptationTraits::Site_2 Site2;
-typedef Kernel::Point_2 Point2;
+#include "voronoi.hpp"
 
 /*
     Function: displayVoronoiDiagram
@@ -77,42 +54,557 @@ void displayVoronoiDiagram(const VoronoiDiagram &voronoiDiagram, const vector<Po
 }
 
 /*
-    Function: main
+    Function: writeVoronoiDiagram
     Description:
-    Defines a set of 2D points, constructs a Voronoi diagram using CGAL, 
-    and displays the site coordinates and resulting Voronoi cells.
+    Walks the bounded faces once and streams the sites and polygons
+    through the writer in chunks.
 
     Parameters:
+    voronoiDiagram: The Voronoi diagram object constructed from the given points.
+    points: Vector of 2D points used as sites to generate the Voronoi diagram.
+    writer: JSON or binary polygon writer
+
+    Return value:
+    true if every write succeeded
+*/
+bool writeVoronoiDiagram(const VoronoiDiagram &voronoiDiagram, const vector<Point2> &points, PolygonWriter &writer) {
+    vector<double> xy;
+    xy.reserve(points.size() * 2);
+    for (const auto &point : points) {
+        xy.push_back(point.x());
+        xy.push_back(point.y());
+    }
+    writer.writeSites(xy.data(), points.size());
+    vector<double>().swap(xy);
+
+    for (auto face = voronoiDiagram.faces_begin(); face != voronoiDiagram.faces_end(); ++face) {
+        if (face->is_unbounded()) {
+            continue;
+        }
+        writer.beginPolygon();
+        auto edgeStart = face->ccb();
+        auto edge = edgeStart;
+        do {
+            auto source = edge->source()->point();
+            writer.addVertex(source.x(), source.y());
+            ++edge;
+        } while (edge != edgeStart);
+        writer.endPolygon();
+    }
+    return writer.finish();
+}
+
+/*
+    Function: buildTriangulation
+    Description:
+    Range-inserts the points tagged with their input index. The insert
+    spatially sorts (point, index) pairs the same way it sorts plain
+    points.
+
+    Parameters:
+    points: sites
+    triangulation: output, cleared first
+
+    Return value:
     None
+*/
+void buildTriangulation(const vector<Point2> &points, DelaunayTriangulation &triangulation) {
+    vector<pair<Point2, unsigned>> tagged;
+    tagged.reserve(points.size());
+    for (size_t i = 0; i < points.size(); i++) {
+        tagged.push_back({points[i], (unsigned)i});
+    }
+    triangulation.clear();
+    triangulation.insert(tagged.begin(), tagged.end());
+}
+
+/*
+    Function: buildVoronoiDiagram
+    Description:
+    Builds the diagram of all points at once. Delaunay_triangulation_2's
+    range insert spatially sorts the points (Hilbert order) and inserts
+    each one next to the previous, so point location stays local. The
+    finished triangulation is swapped into the diagram, not copied.
+
+    Parameters:
+    points: sites, frame points included
 
     Return value:
-    0 — indicates successful execution.
+    The Voronoi diagram of the points
 */
-int main() {
-    // Main site points
-    vector<Point2> points = {
-        Point2(200, 500),
-        Point2(300, 100),
-        Point2(450, 150),
-        Point2(520, 480)
+VoronoiDiagram buildVoronoiDiagram(const vector<Point2> &points) {
+    DelaunayTriangulation triangulation;
+    buildTriangulation(points, triangulation);
+    return VoronoiDiagram(triangulation, true);
+}
+
+/*
+    Function: nearestFrom
+    Description:
+    Greedy walk over the Delaunay graph: moves to any neighbor strictly
+    closer to p until none is. A site that is not the nearest always has
+    a closer Delaunay neighbor (p lies beyond one of the bisectors that
+    bound its Voronoi cell), so the walk ends at a nearest site. The
+    distance comparison is an exact predicate and nothing is written to
+    the triangulation.
+
+    Parameters:
+    triangulation: triangulation of dimension 2
+    v: finite start vertex
+    p: query point
+
+    Return value:
+    A vertex nearest to p
+*/
+static DelaunayTriangulation::Vertex_handle nearestFrom(const DelaunayTriangulation &triangulation,
+                                                        DelaunayTriangulation::Vertex_handle v, const Point2 &p) {
+    bool moved = true;
+    while (moved) {
+        moved = false;
+        auto neighbor = triangulation.incident_vertices(v), done = neighbor;
+        do {
+            if (!triangulation.is_infinite(neighbor) &&
+                CGAL::compare_distance_to_point(p, neighbor->point(), v->point()) == CGAL::SMALLER) {
+                v = neighbor;
+                moved = true;
+                break;
+            }
+        } while (++neighbor != done);
+    }
+    return v;
+}
+
+/*
+    Function: locate
+    Description:
+    Finds the nearest site for every query point. Below dimension 2
+    CGAL's nearest_vertex does a plain scan without point location, so
+    it is safe to share between workers.
+
+    Parameters:
+    queries: query points
+    sites: output, input index of the nearest site per query
+    threads: worker count (0 = hardware threads)
+
+    Return value:
+    None
+*/
+void NearestSiteLocator::locate(const vector<Point2> &queries, vector<unsigned> &sites, unsigned threads) const {
+    sites.assign(queries.size(), 0);
+    if (triangulation.number_of_vertices() == 0) {
+        return;
+    }
+    vector<size_t> order(queries.size());
+    iota(order.begin(), order.end(), size_t(0));
+    CGAL::spatial_sort(order.begin(), order.end(), IndexSortTraits(CGAL::make_property_map(queries)));
+
+    ThreadPool pool(threads);
+    size_t grain = max<size_t>(queries.size() / (pool.size() * 8), 4096);
+    pool.parallelFor(order.size(), grain, [&](unsigned, size_t begin, size_t end) {
+        DelaunayTriangulation::Vertex_handle nearest = triangulation.finite_vertices_begin();
+        for (size_t k = begin; k < end; k++) {
+            size_t q = order[k];
+            nearest = triangulation.dimension() == 2 ? nearestFrom(triangulation, nearest, queries[q])
+                                                     : triangulation.nearest_vertex(queries[q]);
+            sites[q] = nearest->info();
+        }
+    });
+}
+
+/*
+    Function: SiteGrid::missingSiteNear
+    Description:
+    Looks for a site outside region, so missing from a tile's
+    triangulation, closer than reach to (x, y). Buckets whose sites all
+    lie inside region, or whose box is out of reach, are skipped whole.
+
+    Return value:
+    true if such a site exists
+*/
+bool SiteGrid::missingSiteNear(const SiteBounds &region, double x, double y, double reach) const {
+    double reach2 = reach * reach;
+    for (int gy = row(y - reach); gy <= row(y + reach); gy++) {
+        for (int gx = column(x - reach); gx <= column(x + reach); gx++) {
+            int b = gy * side + gx;
+            const SiteBounds &near = bucketBox[b];
+            if (bucket[b].empty() || (near.minX >= region.minX && near.maxX <= region.maxX &&
+                                      near.minY >= region.minY && near.maxY <= region.maxY)) {
+                continue;
+            }
+            double dx = max(max(near.minX - x, x - near.maxX), 0.0);
+            double dy = max(max(near.minY - y, y - near.maxY), 0.0);
+            if (dx * dx + dy * dy >= reach2) {
+                continue;
+            }
+            for (unsigned i : bucket[b]) {
+                double ex = xy[i].x - x, ey = xy[i].y - y;
+                if (ex * ex + ey * ey < reach2 && !inside(region, i)) {
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+/*
+    Function: voronoiCell
+    Description:
+    Builds the cell of v from the circumcenters of its incident faces,
+    counterclockwise. Each circumcenter takes its three points in site
+    index order, and the polygon starts at its lowest (x, y) vertex, so
+    for sites in general position the same cell gives the same doubles
+    in any triangulation that contains its star. With four or more
+    cocircular sites the Delaunay diagonals are not unique; different
+    triangulations can then give slightly different or repeated vertices
+    for the same Voronoi vertex. Only exact repeats are dropped here.
+    A tile's triangulation holds every hull vertex, so its convex hull
+    is the global one and an infinite face still means an unbounded
+    cell. Its other triangles are only trusted when no site missing
+    from the tile lies in (or within rounding of) their circumcircle.
+
+    Parameters:
+    triangulation: tile or global triangulation
+    v: vertex of the site
+    scope: contents of the tile triangulation, or nullptr when it holds
+    every site
+    polygon: output, interleaved coordinates
+
+    Return value:
+    Bounded with the polygon filled, Unbounded for sites on the convex
+    hull of all sites, Uncertain if the tile's sites cannot decide
+*/
+CellStatus voronoiCell(const DelaunayTriangulation &triangulation, DelaunayTriangulation::Vertex_handle v,
+                       const TileScope *scope, vector<double> &polygon) {
+    polygon.clear();
+    if (triangulation.dimension() < 2) {
+        return CellStatus::Unbounded;
+    }
+    // Rounding scale of the circumcenters: the size of the coordinates
+    double extent = 0;
+    if (scope) {
+        const SiteBounds &box = scope->grid->box;
+        extent = max(max(fabs(box.minX), fabs(box.maxX)), max(fabs(box.minY), fabs(box.maxY)));
+        extent = max(extent, max(box.maxX - box.minX, box.maxY - box.minY));
+    }
+    auto face = triangulation.incident_faces(v), done = face;
+    do {
+        if (triangulation.is_infinite(face)) {
+            return CellStatus::Unbounded;
+        }
+        DelaunayTriangulation::Vertex_handle corner[3] = {face->vertex(0), face->vertex(1), face->vertex(2)};
+        sort(corner, corner + 3, [](DelaunayTriangulation::Vertex_handle a, DelaunayTriangulation::Vertex_handle b) {
+            return a->info() < b->info();
+        });
+        Point2 center = CGAL::circumcenter(corner[0]->point(), corner[1]->point(), corner[2]->point());
+        if (scope) {
+            double radius = sqrt(CGAL::squared_distance(center, corner[0]->point()));
+            double slack = 1e-9 * (radius + extent);
+            if (scope->grid->missingSiteNear(scope->region, center.x(), center.y(), radius + slack)) {
+                return CellStatus::Uncertain;
+            }
+        }
+        size_t last = polygon.size();
+        if (last == 0 || polygon[last - 2] != center.x() || polygon[last - 1] != center.y()) {
+            polygon.push_back(center.x());
+            polygon.push_back(center.y());
+        }
+    } while (++face != done);
+
+    size_t count = polygon.size() / 2;
+    if (count > 1 && polygon[0] == polygon[2 * count - 2] && polygon[1] == polygon[2 * count - 1]) {
+        polygon.resize(2 * --count);
+    }
+    size_t first = 0;
+    for (size_t i = 1; i < count; i++) {
+        if (make_pair(polygon[2 * i], polygon[2 * i + 1]) < make_pair(polygon[2 * first], polygon[2 * first + 1])) {
+            first = i;
+        }
+    }
+    rotate(polygon.begin(), polygon.begin() + 2 * first, polygon.end());
+    return CellStatus::Bounded;
+}
+
+/*
+    Function: tiledVoronoiCells
+    Description:
+    Computes every bounded cell with the sites split into a grid x grid
+    set of tiles, each triangulated on its own worker.
+    The convex hull is found once. Hull vertices have unbounded cells,
+    so they are decided up front, and they join every tile's
+    triangulation so that a tile never mistakes its own border for the
+    hull. The grid is laid over the bounding box of the other sites
+    only, so frame points far outside (boundingSites) do not leave most
+    tiles empty, and tiles without sites are never triangulated.
+    A tile's triangulation holds its own sites plus ghost sites within
+    a margin around it. Cells it can certify (see voronoiCell) go
+    straight into that tile's results. The rest, cells whose circles
+    reach sites beyond the margin, are retried in merge rounds. Each
+    round doubles the margin. Once a region covers every site, all of
+    its cells are decided.
+    The cells are finally stitched together in site order, so for
+    distinct sites in general position every grid gives the same cells,
+    double for double, as grid = 1, which triangulates all sites at
+    once (tests/voronoi_test.cpp checks this). The listing is not the
+    writeVoronoiDiagram() output: cells come in site order and start at
+    their lowest vertex, while the diagram writer follows face order and
+    its degeneracy-removal policy merges the vertices of cocircular
+    sites. With cocircular sites (lattices) the vertex lists may also
+    differ between grids, as described in voronoiCell.
+
+    Parameters:
+    points: sites
+    grid: tiles per side
+    threads: worker count (0 = hardware threads)
+
+    Return value:
+    The bounded cells, ordered by site index
+*/
+CellList tiledVoronoiCells(const vector<Point2> &points, int grid, unsigned threads) {
+    size_t n = points.size();
+    grid = max(grid, 1);
+
+    vector<size_t> indices(n), hull;
+    iota(indices.begin(), indices.end(), size_t(0));
+    CGAL::convex_hull_2(indices.begin(), indices.end(), back_inserter(hull),
+                        IndexHullTraits(CGAL::make_property_map(points)));
+    vector<char> onHull(n, 0);
+    vector<pair<Point2, unsigned>> hullSites;
+    for (size_t i : hull) {
+        onHull[i] = 1;
+        hullSites.push_back({points[i], (unsigned)i});
+    }
+
+    // The other sites, bucketed by tile over their own bounding box
+    SiteGrid sites;
+    sites.side = grid;
+    sites.xy.resize(n);
+    vector<SitePoint> inner;
+    for (size_t i = 0; i < n; i++) {
+        sites.xy[i] = {points[i].x(), points[i].y()};
+        if (!onHull[i]) {
+            inner.push_back(sites.xy[i]);
+        }
+    }
+    if (inner.empty()) {
+        return CellList();
+    }
+    SiteBounds box = sites.box = siteBounds(inner);
+    sites.width = max(box.maxX - box.minX, 1e-300) / grid;
+    sites.height = max(box.maxY - box.minY, 1e-300) / grid;
+
+    int tiles = grid * grid;
+    vector<int> tileOf(n, -1);
+    sites.bucket.resize(tiles);
+    sites.bucketBox.assign(tiles, {HUGE_VAL, HUGE_VAL, -HUGE_VAL, -HUGE_VAL});
+    for (size_t i = 0; i < n; i++) {
+        if (onHull[i]) {
+            continue;
+        }
+        const SitePoint &p = sites.xy[i];
+        tileOf[i] = sites.row(p.y) * grid + sites.column(p.x);
+        sites.bucket[tileOf[i]].push_back((unsigned)i);
+        SiteBounds &b = sites.bucketBox[tileOf[i]];
+        b = {min(b.minX, p.x), min(b.minY, p.y), max(b.maxX, p.x), max(b.maxY, p.y)};
+    }
+
+    double area = (box.maxX - box.minX) * (box.maxY - box.minY);
+    double margin = area > 0 ? 3 * sqrt(area / inner.size()) : max(box.maxX - box.minX, box.maxY - box.minY);
+    margin = max(margin, 1e-9);
+
+    ThreadPool pool(threads);
+    vector<CellList> found(tiles);
+    vector<char> pending(n, 1);
+    vector<vector<unsigned>> retry(tiles);
+    vector<int> active;
+    for (int tile = 0; tile < tiles; tile++) {
+        if (!sites.bucket[tile].empty()) {
+            active.push_back(tile);
+        }
+    }
+
+    while (!active.empty()) {
+        pool.parallelFor(active.size(), 1, [&](unsigned, size_t begin, size_t end) {
+            vector<double> polygon;
+            for (size_t a = begin; a < end; a++) {
+                int tile = active[a];
+                int tx = tile % grid, ty = tile / grid;
+                TileScope scope = {&sites,
+                                   {box.minX + tx * sites.width - margin, box.minY + ty * sites.height - margin,
+                                    box.minX + (tx + 1) * sites.width + margin,
+                                    box.minY + (ty + 1) * sites.height + margin}};
+                const SiteBounds &region = scope.region;
+                bool coversAll = region.minX <= box.minX && region.minY <= box.minY &&
+                                 region.maxX >= box.maxX && region.maxY >= box.maxY;
+
+                vector<pair<Point2, unsigned>> local = hullSites;
+                for (int gy = sites.row(region.minY); gy <= sites.row(region.maxY); gy++) {
+                    for (int gx = sites.column(region.minX); gx <= sites.column(region.maxX); gx++) {
+                        for (unsigned i : sites.bucket[gy * grid + gx]) {
+                            if (sites.inside(region, i)) {
+                                local.push_back({points[i], i});
+                            }
+                        }
+                    }
+                }
+                DelaunayTriangulation triangulation;
+                triangulation.insert(local.begin(), local.end());
+
+                CellList &cells = found[tile];
+                retry[tile].clear();
+                for (auto v = triangulation.finite_vertices_begin(); v != triangulation.finite_vertices_end(); ++v) {
+                    unsigned site = v->info();
+                    if (tileOf[site] != tile || !pending[site]) {
+                        continue;
+                    }
+                    CellStatus status = voronoiCell(triangulation, v, coversAll ? nullptr : &scope, polygon);
+                    if (status == CellStatus::Uncertain) {
+                        retry[tile].push_back(site);
+                    } else if (status == CellStatus::Bounded) {
+                        cells.sites.push_back(site);
+                        cells.sizes.push_back((uint32_t)(polygon.size() / 2));
+                        cells.xy.insert(cells.xy.end(), polygon.begin(), polygon.end());
+                    }
+                }
+            }
+        });
+
+        // Merge round: only the border cells left undecided are recomputed
+        fill(pending.begin(), pending.end(), 0);
+        vector<int> next;
+        for (int tile : active) {
+            for (unsigned site : retry[tile]) {
+                pending[site] = 1;
+            }
+            if (!retry[tile].empty()) {
+                next.push_back(tile);
+            }
+        }
+        active.swap(next);
+        margin *= 2;
+    }
+
+    // Stitch the tiles' cells into one list in site order
+    struct Location {
+        unsigned site;
+        int tile;
+        size_t offset;
+        uint32_t size;
     };
+    vector<Location> order;
+    for (int tile = 0; tile < tiles; tile++) {
+        size_t offset = 0;
+        for (size_t c = 0; c < found[tile].sites.size(); c++) {
+            order.push_back({found[tile].sites[c], tile, offset, found[tile].sizes[c]});
+            offset += 2 * found[tile].sizes[c];
+        }
+    }
+    sort(order.begin(), order.end(), [](const Location &a, const Location &b) { return a.site < b.site; });
 
-    // Additional points to enclose the diagram boundaries
-    points.push_back(Point2(-1000, -1000));
-    points.push_back(Point2(-1000, 1000));
-    points.push_back(Point2(1000, -1000));
-    points.push_back(Point2(1000, 1000));
+    CellList result;
+    for (const auto &cell : order) {
+        const double *source = &found[cell.tile].xy[cell.offset];
+        result.sites.push_back(cell.site);
+        result.sizes.push_back(cell.size);
+        result.xy.insert(result.xy.end(), source, source + 2 * cell.size);
+    }
+    return result;
+}
+
+/*
+    Function: writeCellList
+    Description:
+    Writes the sites and cells through the polygon writer, or as the text
+    listing when writer is nullptr.
 
-    // Construct the Voronoi diagram
-    VoronoiDiagram voronoiDiagram;
+    Return value:
+    true if every write succeeded
+*/
+bool writeCellList(const CellList &cells, const vector<Point2> &points, PolygonWriter *writer) {
+    if (writer == nullptr) {
+        cout << "Voronoi polygons:\n[\n";
+        const double *xy = cells.xy.data();
+        for (size_t c = 0; c < cells.sites.size(); c++) {
+            cout << "  [";
+            for (uint32_t v = 0; v < cells.sizes[c]; v++, xy += 2) {
+                cout << "(" << xy[0] << "," << xy[1] << ")" << (v + 1 < cells.sizes[c] ? ", " : "");
+            }
+            cout << "],\n";
+        }
+        cout << "]\n";
+        return true;
+    }
+    vector<double> sites;
+    sites.reserve(points.size() * 2);
     for (const auto &point : points) {
-        voronoiDiagram.insert(Site2(point));
+        sites.push_back(point.x());
+        sites.push_back(point.y());
     }
+    writer->writeSites(sites.data(), points.size());
+    const double *xy = cells.xy.data();
+    for (size_t c = 0; c < cells.sites.size(); c++) {
+        writer->beginPolygon();
+        for (uint32_t v = 0; v < cells.sizes[c]; v++, xy += 2) {
+            writer->addVertex(xy[0], xy[1]);
+        }
+        writer->endPolygon();
+    }
+    return writer->finish();
+}
+
+vector<Point2> toPoints(const vector<SitePoint> &sites) {
+    vector<Point2> points;
+    points.reserve(sites.size());
+    for (const auto &site : sites) {
+        points.push_back(Point2(site.x, site.y));
+    }
+    return points;
+}
+
+/*
+    Function: answerQueries
+    Description:
+    Builds the triangulation once, assigns every query to its nearest
+    site and reports build and query throughput on stderr.
+
+    Parameters:
+    sites: site points
+    queries: query points
+    assigned: output, nearest site index per query
+
+    Return value:
+    None
+*/
+void answerQueries(const vector<SitePoint> &sites, const vector<SitePoint> &queries, vector<unsigned> &assigned) {
+    using Clock = chrono::steady_clock;
+    auto start = Clock::now();
+    DelaunayTriangulation triangulation;
+    buildTriangulation(toPoints(sites), triangulation);
+    auto built = Clock::now();
 
-    // Display the diagram’s sites and polygons
-    displayVoronoiDiagram(voronoiDiagram, points);
+    NearestSiteLocator locator(triangulation);
+    vector<Point2> points = toPoints(queries);
+    auto queryStart = Clock::now();
+    locator.locate(points, assigned);
+    auto done = Clock::now();
 
-    return 0;
+    double buildSeconds = chrono::duration<double>(built - start).count();
+    double querySeconds = chrono::duration<double>(done - queryStart).count();
+    cerr << "Built triangulation of " << sites.size() << " sites in " << buildSeconds << " s\n";
+    cerr << "Answered " << queries.size() << " queries in " << querySeconds << " s ("
+         << (querySeconds > 0 ? queries.size() / querySeconds : 0) << " queries/s)\n";
 }
 
-#endif
+/*
+    Function: sampleVoronoiSites
+    Description:
+    The four sample sites used when no site file is given.
+*/
+vector<SitePoint> sampleVoronoiSites() {
+    return {
+        {200, 500},
+        {300, 100},
+        {450, 150},
+        {520, 480}
+    };
+}
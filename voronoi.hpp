@@ -0,0 +1,153 @@
+/* 
+    Voronoi Diagram 
+    Description:
+    Library that constructs Voronoi diagrams from sets of 2D points using
+    the CGAL (Computational Geometry Algorithms Library) and outputs the
+    coordinates of the sites and the vertices of each Voronoi cell.
+    The diagram is built in bulk: one range insert into a Delaunay
+    triangulation, which sorts the points along a Hilbert curve first,
+    then adapted into the diagram. Cells can be listed as text (a debug
+    format) or streamed as JSON / binary (see polygon_writer.hpp).
+    tiledVoronoiCells() computes the cells on a grid of tiles in parallel
+    and NearestSiteLocator answers batches of nearest-site queries.
+    The voronoi tool (voronoi_main.cpp) and the main driver link it.
+*/
+
+#ifndef VORONOI_DIAGRAM_HPP
+#define VORONOI_DIAGRAM_HPP
+
+#include <CGAL/Exact_predicates_inexact_constructions_kernel.h>
+#include <CGAL/Voronoi_diagram_2.h>
+#include <CGAL/Delaunay_triangulation_2.h>
+#include <CGAL/Delaunay_triangulation_adaptation_traits_2.h>
+#include <CGAL/Delaunay_triangulation_adaptation_policies_2.h>
+#include <CGAL/Triangulation_vertex_base_with_info_2.h>
+#include <CGAL/Triangulation_data_structure_2.h>
+#include <CGAL/Spatial_sort_traits_adapter_2.h>
+#include <CGAL/Convex_hull_traits_adapter_2.h>
+#include <CGAL/convex_hull_2.h>
+#include <CGAL/property_map.h>
+#include <CGAL/spatial_sort.h>
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <cstring>
+#include <numeric>
+#include <cmath>
+#include <algorithm>
+#include "voronoi_sites.hpp"
+#include "thread_pool.hpp"
+#include "polygon_writer.hpp"
+using namespace std;
+
+// Type definitions for geometric kernel and structures
+typedef CGAL::Exact_predicates_inexact_constructions_kernel Kernel;
+// Each vertex keeps the index of its site in the input
+typedef CGAL::Triangulation_vertex_base_with_info_2<unsigned, Kernel> VertexBase;
+typedef CGAL::Triangulation_data_structure_2<VertexBase> TriangulationData;
+typedef CGAL::Delaunay_triangulation_2<Kernel, TriangulationData> DelaunayTriangulation;
+typedef CGAL::Delaunay_triangulation_adaptation_traits_2<DelaunayTriangulation> AdaptationTraits;
+typedef CGAL::Delaunay_triangulation_caching_degeneracy_removal_policy_2<DelaunayTriangulation> AdaptationPolicy;
+typedef CGAL::Voronoi_diagram_2<DelaunayTriangulation, AdaptationTraits, AdaptationPolicy> VoronoiDiagram;
+
+typedef AdaptationTraits::Site_2 Site2;
+typedef Kernel::Point_2 Point2;
+typedef CGAL::Spatial_sort_traits_adapter_2<Kernel, CGAL::Pointer_property_map<Point2>::const_type> IndexSortTraits;
+typedef CGAL::Convex_hull_traits_adapter_2<Kernel, CGAL::Pointer_property_map<Point2>::const_type> IndexHullTraits;
+
+/*
+    Structure: CellList
+    Description:
+    Bounded Voronoi cells in flat buffers: cell i belongs to sites[i] and
+    has sizes[i] vertices, stored consecutively in xy as (x, y) pairs.
+*/
+struct CellList {
+    vector<unsigned> sites;
+    vector<uint32_t> sizes;
+    vector<double> xy;
+};
+
+enum class CellStatus {
+    Bounded,
+    Unbounded,
+    Uncertain
+};
+
+/*
+    Structure: SiteGrid
+    Description:
+    The sites that are not convex hull vertices, bucketed on a side x side
+    grid over their own bounding box. Each bucket also keeps the bounding
+    box of its sites, so a circle is only tested against the sites of
+    buckets it can reach.
+*/
+struct SiteGrid {
+    SiteBounds box;
+    int side = 1;
+    double width = 1, height = 1;
+    vector<SitePoint> xy;                 // every site, by input index
+    vector<vector<unsigned>> bucket;
+    vector<SiteBounds> bucketBox;
+
+    // Clamped in floating point, before the cast can overflow
+    int column(double x) const { return cell((x - box.minX) / width); }
+    int row(double y) const { return cell((y - box.minY) / height); }
+    int cell(double t) const { return t <= 0 ? 0 : t >= side ? side - 1 : (int)t; }
+
+    bool inside(const SiteBounds &region, unsigned i) const {
+        return xy[i].x >= region.minX && xy[i].x <= region.maxX && xy[i].y >= region.minY && xy[i].y <= region.maxY;
+    }
+
+    bool missingSiteNear(const SiteBounds &region, double x, double y, double reach) const;
+};
+
+/*
+    Structure: TileScope
+    Description:
+    What a tile's triangulation holds: every convex hull vertex plus the
+    grid's sites inside region.
+*/
+struct TileScope {
+    const SiteGrid *grid;
+    SiteBounds region;
+};
+
+/*
+    Class: NearestSiteLocator
+    Description:
+    Answers nearest-site queries on a Delaunay triangulation built once.
+    Each batch is spatially sorted first. Every query then walks the
+    Delaunay graph from the previous answer, so consecutive lookups only
+    move a few vertices. Workers take contiguous runs of the sorted
+    batch, so each run stays spatially coherent. The walk is our own
+    rather than nearest_vertex(): CGAL's point location draws from a
+    random generator stored in the triangulation, so concurrent calls on
+    one triangulation race, while the walk only reads it.
+*/
+class NearestSiteLocator {
+public:
+    explicit NearestSiteLocator(const DelaunayTriangulation &triangulation) : triangulation(triangulation) {}
+
+    // Function: locate
+    // Finds the input index of the nearest site for every query point
+    void locate(const vector<Point2> &queries, vector<unsigned> &sites, unsigned threads = 0) const;
+
+private:
+    const DelaunayTriangulation &triangulation;
+};
+
+// Functions defined in voronoi.cpp; see the comments there
+void displayVoronoiDiagram(const VoronoiDiagram &voronoiDiagram, const vector<Point2> &points);
+bool writeVoronoiDiagram(const VoronoiDiagram &voronoiDiagram, const vector<Point2> &points, PolygonWriter &writer);
+void buildTriangulation(const vector<Point2> &points, DelaunayTriangulation &triangulation);
+VoronoiDiagram buildVoronoiDiagram(const vector<Point2> &points);
+CellStatus voronoiCell(const DelaunayTriangulation &triangulation, DelaunayTriangulation::Vertex_handle v,
+                       const TileScope *scope, vector<double> &polygon);
+CellList tiledVoronoiCells(const vector<Point2> &points, int grid, unsigned threads = 0);
+bool writeCellList(const CellList &cells, const vector<Point2> &points, PolygonWriter *writer);
+vector<Point2> toPoints(const vector<SitePoint> &sites);
+void answerQueries(const vector<SitePoint> &sites, const vector<SitePoint> &queries, vector<unsigned> &assigned);
+vector<SitePoint> sampleVoronoiSites();
+
+#endif
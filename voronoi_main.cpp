@@ -0,0 +1,174 @@
+/* 
+    Voronoi tool
+    Description:
+    Command-line front end of the Voronoi library. It constructs and
+    displays a Voronoi diagram of the sites in a text or binary file
+    (see voronoi_sites.hpp) given on the command line, or of four sample
+    sites. Output is the readable text listing by default, or a streamed
+    JSON / binary file with --format. With --tiles G the cells are
+    computed on a G x G grid of tiles in parallel and listed in site
+    order; that listing is not byte-identical to the untiled output (see
+    tiledVoronoiCells). With --query or --query-bench the tool instead answers batches
+    of nearest-site queries on the triangulation.
+*/
+
+#include "voronoi.hpp"
+
+/*
+    Function: runQueries
+    Description:
+    voronoi --query <sites> <queries> [output]
+    Assigns each query point (same file formats as sites) to its nearest
+    site. The output file, if given, holds one uint32 site index per
+    query in query order.
+
+    Return value:
+    0 on success, 1 on an input or output error
+*/
+int runQueries(int argc, char *argv[]) {
+    vector<SitePoint> sites, queries;
+    if (argc < 4) {
+        cerr << "Usage: voronoi --query <sites> <queries> [output]\n";
+        return 1;
+    }
+    if (!readSites(argv[2], sites) || !readSites(argv[3], queries)) {
+        return 1;
+    }
+    vector<unsigned> assigned;
+    answerQueries(sites, queries, assigned);
+    if (argc > 4) {
+        FILE *out = fopen(argv[4], "wb");
+        bool ok = out && fwrite(assigned.data(), sizeof(unsigned), assigned.size(), out) == assigned.size();
+        if (out && fclose(out) != 0) ok = false;
+        if (!ok) {
+            cerr << "Error: could not write " << argv[4] << "\n";
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/*
+    Function: runQueryBenchmark
+    Description:
+    voronoi --query-bench [sites] [count]
+    Times count uniform random queries (default 10M) over the sites'
+    bounding box. Without a site file, 1M uniform random sites are used.
+
+    Return value:
+    0 on success, 1 if the site file cannot be read
+*/
+int runQueryBenchmark(int argc, char *argv[]) {
+    mt19937_64 rng(12345);
+    vector<SitePoint> sites;
+    if (argc > 2 && strcmp(argv[2], "-") != 0) {
+        if (!readSites(argv[2], sites)) {
+            return 1;
+        }
+    } else {
+        uniform_real_distribution<double> coordinate(0, 1e6);
+        sites.resize(1000000);
+        for (auto &site : sites) {
+            site = {coordinate(rng), coordinate(rng)};
+        }
+    }
+    size_t count = argc > 3 ? strtoull(argv[3], nullptr, 10) : 10000000;
+
+    SiteBounds box = siteBounds(sites);
+    uniform_real_distribution<double> x(box.minX, box.maxX), y(box.minY, box.maxY);
+    vector<SitePoint> queries(count);
+    for (auto &query : queries) {
+        query = {x(rng), y(rng)};
+    }
+    vector<unsigned> assigned;
+    answerQueries(sites, queries, assigned);
+    return 0;
+}
+
+/*
+    Function: main
+    Description:
+    Loads the sites (or uses four sample sites), frames them with four
+    points around their bounding box, constructs the Voronoi diagram
+    and displays the site coordinates and resulting Voronoi cells.
+
+    Parameters:
+    argv[1]: optional text or binary site file, or --query / --query-bench
+    --format: text (default), json or binary
+    --output: file for json / binary output (default: standard output)
+    --tiles: tiles per side for the parallel cell construction
+
+    Return value:
+    0 — indicates successful execution, 1 if the site file cannot be read.
+*/
+int main(int argc, char *argv[]) {
+    if (argc > 1 && strcmp(argv[1], "--query") == 0) {
+        return runQueries(argc, argv);
+    }
+    if (argc > 1 && strcmp(argv[1], "--query-bench") == 0) {
+        return runQueryBenchmark(argc, argv);
+    }
+
+    // voronoi [sites] [--format text|json|binary] [--output file] [--tiles G]
+    const char *siteFile = nullptr;
+    int grid = 0;
+    const char *outputFile = nullptr;
+    string format = "text";
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+            format = argv[++i];
+        } else if (strcmp(argv[i], "--tiles") == 0 && i + 1 < argc) {
+            grid = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            outputFile = argv[++i];
+        } else {
+            siteFile = argv[i];
+        }
+    }
+    if (format != "text" && format != "json" && format != "binary") {
+        cerr << "Error: unknown format " << format << " (text, json or binary)\n";
+        return 1;
+    }
+
+    // Main site points
+    vector<SitePoint> sites = sampleVoronoiSites();
+    if (siteFile != nullptr && !readSites(siteFile, sites)) {
+        return 1;
+    }
+
+    // Additional points to enclose the diagram boundaries
+    for (const auto &corner : boundingSites(siteBounds(sites))) {
+        sites.push_back(corner);
+    }
+
+    vector<Point2> points = toPoints(sites);
+
+    if (grid <= 0 && format == "text") {
+        // Construct the Voronoi diagram
+        VoronoiDiagram voronoiDiagram = buildVoronoiDiagram(points);
+
+        // Display the diagram’s sites and polygons
+        displayVoronoiDiagram(voronoiDiagram, points);
+        return 0;
+    }
+    if (grid > 0 && format == "text") {
+        return writeCellList(tiledVoronoiCells(points, grid), points, nullptr) ? 0 : 1;
+    }
+
+    FILE *out = outputFile ? fopen(outputFile, "wb") : stdout;
+    if (out == nullptr) {
+        cerr << "Error: could not open " << outputFile << "\n";
+        return 1;
+    }
+    PolygonWriter writer(out, format == "json" ? PolygonWriter::Format::Json : PolygonWriter::Format::Binary);
+    bool written = grid > 0 ? writeCellList(tiledVoronoiCells(points, grid), points, &writer)
+                            : writeVoronoiDiagram(buildVoronoiDiagram(points), points, writer);
+    if (outputFile && fclose(out) != 0) {
+        written = false;
+    }
+    if (!written) {
+        cerr << "Error: could not write the diagram\n";
+        return 1;
+    }
+    return 0;
+}
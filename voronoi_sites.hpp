@@ -0,0 +1,170 @@
+/*
+    Voronoi site input
+    Description:
+    Loads Voronoi sites from a text file ("N", then N lines "x y") or from
+    a binary point array (magic "PTS2", uint64 N, then N (x, y) pairs of
+    doubles). Both are read through a memory-mapped view; the binary
+    layout is copied straight out of the mapping. siteBounds() and
+    boundingSites() replace fixed frame points: the four added corners sit
+    outside the sites' bounding box by twice its larger side.
+*/
+
+#ifndef VORONOI_SITES_HPP
+#define VORONOI_SITES_HPP
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <charconv>
+#include <cmath>
+#include <algorithm>
+#include "dimacs_loader.hpp"   // MappedFile
+using namespace std;
+
+struct SitePoint {
+    double x, y;
+};
+
+struct SiteBounds {
+    double minX, minY, maxX, maxY;
+};
+
+inline constexpr char binarySiteMagic[4] = {'P', 'T', 'S', '2'};
+
+/*
+    Function: readSites
+    Description:
+    Reads a text or binary site file; the format is detected from the
+    first four bytes.
+
+    Parameters:
+    filename: site file
+    sites: output points
+
+    Return value:
+    true on success; false (with a message) if the file cannot be mapped,
+    is malformed, declares more sites than it can hold or has a
+    non-finite coordinate
+*/
+inline bool readSites(const string &filename, vector<SitePoint> &sites) {
+    MappedFile file(filename);
+    const char *p = file.data();
+    const char *end = p + file.size();
+    if (p == nullptr) {
+        cerr << "Error: could not map site file " << filename << "\n";
+        return false;
+    }
+
+    if (file.size() >= 12 && memcmp(p, binarySiteMagic, 4) == 0) {
+        uint64_t count;
+        memcpy(&count, p + 4, sizeof count);
+        if (count > (file.size() - 12) / sizeof(SitePoint)) {
+            cerr << "Error: site file " << filename << " is truncated\n";
+            return false;
+        }
+        sites.resize(count);
+        memcpy(sites.data(), p + 12, count * sizeof(SitePoint));
+        for (size_t i = 0; i < count; i++) {
+            if (!isfinite(sites[i].x) || !isfinite(sites[i].y)) {
+                cerr << "Error: site " << i << " in " << filename << " is not finite\n";
+                return false;
+            }
+        }
+        return true;
+    }
+
+    auto skip = [&] {
+        while (p < end && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t')) p++;
+    };
+    auto number = [&](double &value) {
+        skip();
+        if (p < end && *p == '+') p++;
+        auto result = from_chars(p, end, value);
+        if (result.ec != errc()) return false;
+        p = result.ptr;
+        return true;
+    };
+
+    double declared;
+    if (!number(declared) || !isfinite(declared) || declared < 0 || declared != floor(declared)) {
+        cerr << "Error: site file " << filename << " has no site count\n";
+        return false;
+    }
+    // Every site takes at least 4 bytes ("0 0\n"), the last one 3
+    if (declared > (double)((file.size() + 1) / 4)) {
+        cerr << "Error: site file " << filename << " declares " << declared << " sites but is too short\n";
+        return false;
+    }
+    size_t count = (size_t)declared;
+    sites.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        if (!number(sites[i].x) || !number(sites[i].y)) {
+            cerr << "Error: site file " << filename << " ends at site " << i << "\n";
+            return false;
+        }
+        if (!isfinite(sites[i].x) || !isfinite(sites[i].y)) {
+            cerr << "Error: site " << i << " in " << filename << " is not finite\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+    Function: writeBinarySites
+    Description:
+    Writes sites in the binary format read by readSites.
+
+    Return value:
+    true on success
+*/
+inline bool writeBinarySites(const string &filename, const vector<SitePoint> &sites) {
+    FILE *out = fopen(filename.c_str(), "wb");
+    if (!out) return false;
+    uint64_t count = sites.size();
+    bool ok = fwrite(binarySiteMagic, 1, 4, out) == 4 && fwrite(&count, sizeof count, 1, out) == 1 &&
+              fwrite(sites.data(), sizeof(SitePoint), sites.size(), out) == sites.size();
+    return fclose(out) == 0 && ok;
+}
+
+/*
+    Function: siteBounds
+    Description:
+    Axis-aligned bounding box of the sites ({0, 0, 0, 0} when empty).
+*/
+inline SiteBounds siteBounds(const vector<SitePoint> &sites) {
+    if (sites.empty()) {
+        return {0, 0, 0, 0};
+    }
+    SiteBounds box = {sites[0].x, sites[0].y, sites[0].x, sites[0].y};
+    for (const auto &s : sites) {
+        box.minX = min(box.minX, s.x);
+        box.minY = min(box.minY, s.y);
+        box.maxX = max(box.maxX, s.x);
+        box.maxY = max(box.maxY, s.y);
+    }
+    return box;
+}
+
+/*
+    Function: boundingSites
+    Description:
+    Four frame sites around the box so the cells of the real sites close.
+    The margin is twice the larger side of the box (at least 1), about
+    the ratio the old fixed +-1000 frame had to the sample sites.
+
+    Return value:
+    The corners in the order (-,-), (-,+), (+,-), (+,+)
+*/
+inline vector<SitePoint> boundingSites(const SiteBounds &box) {
+    double margin = 2 * max(max(box.maxX - box.minX, box.maxY - box.minY), 0.5);
+    return {{box.minX - margin, box.minY - margin},
+            {box.minX - margin, box.maxY + margin},
+            {box.maxX + margin, box.minY - margin},
+            {box.maxX + margin, box.maxY + margin}};
+}
+
+#endif